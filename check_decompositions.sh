@@ -0,0 +1,76 @@
+#!/bin/bash
+
+
+function echo_good
+{
+	echo -e "\033[32m$1\033[0m\c"
+}
+
+function echo_bad
+{
+	echo -e "\033[31m$1\033[0m\c"
+}
+
+function echo_success
+{
+	echo_good "[SUCCESS]"
+	echo " $1"
+}
+
+function echo_failure
+{
+	echo_bad "[FAILURE]"
+	echo " $1"
+	exit -1
+}
+
+######################
+# Display quick help #
+######################
+echo "Quick help:";
+echo "  - This script is meant to be run as follows: './check_decompositions.sh [ROWS COLUMNS ITERATIONS]'";
+echo "  - It runs the C CPU version on a ROWSxCOLUMNS plate (default 1000x750) for ITERATIONS iterations (default 401)";
+echo "    with many numbers of MPI processes and OpenMP threads, and checks that all runs print exactly the same";
+echo "    temperature changes and field hashes.";
+echo "  - The MPI launcher can be changed with the MPIRUN environment variable, for instance MPIRUN='mpirun --oversubscribe'.";
+echo "";
+
+rows=${1:-1000}
+columns=${2:-750}
+iterations=${3:-401}
+mpirun_command=${MPIRUN:-mpirun}
+processes=(1 2 3 4 8 16)
+threads=(1 2 4)
+
+binary="./bin/c/cpu_small";
+verifier="./bin/c/verify";
+if [ -x "${binary}" ] && [ -x "${verifier}" ]; then
+	echo_success "The executables \"${binary}\" and \"${verifier}\" have been found."
+else
+	echo_failure "The executables \"${binary}\" and \"${verifier}\" are needed, please compile the CPU versions first."
+fi
+
+output_directory=`mktemp -d`;
+trap "rm -rf ${output_directory}" EXIT
+
+reference_output="";
+for p in "${processes[@]}"; do
+	for t in "${threads[@]}"; do
+		output="${output_directory}/output_${p}_${t}.txt";
+		if ! OMP_NUM_THREADS=${t} ${mpirun_command} -np ${p} ${binary} --rows ${rows} --columns ${columns} --iterations ${iterations} --hash > ${output} 2>&1; then
+			cat ${output}
+			echo_failure "The run on ${p} MPI processes with ${t} OpenMP threads failed."
+		fi
+		if [ ! "${reference_output}" ]; then
+			reference_output=${output};
+			echo_success "Reference run on ${p} MPI processes with ${t} OpenMP threads complete."
+		elif ${verifier} ${output} ${reference_output} > ${output_directory}/verify.txt; then
+			echo_success "${p} MPI processes with ${t} OpenMP threads match the reference run."
+		else
+			cat ${output_directory}/verify.txt
+			echo_failure "${p} MPI processes with ${t} OpenMP threads differ from the reference run."
+		fi
+	done
+done
+
+echo_success "All decompositions of the ${rows}x${columns} plate produced identical temperature changes and field hashes over ${iterations} iterations."
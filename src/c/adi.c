@@ -0,0 +1,254 @@
+/**
+ * @file adi.c
+ * @brief Peaceman-Rachford alternating-direction implicit time stepping.
+ **/
+
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <mpi.h>
+#include <omp.h>
+
+#include "adi.h"
+
+/**
+ * @brief Solves in place (I - r L) x = d along a line, L being the second difference along it.
+ * @details Fixed cells keep their value, and their neighbours see it. An insulated line has one neighbour fewer at each end; otherwise the line is held at 0 beyond its ends.
+ * @param[in,out] x On entry d, on exit x; n contiguous cells.
+ * @param[in] fixed Whether each cell of the line is a fixed source.
+ * @param[in] n The length of the line.
+ * @param[in] r The weight of the neighbours.
+ * @param[in] insulated Whether the ends of the line are insulated.
+ * @param[out] scratch n cells of scratch.
+ **/
+static void solve_line(double* restrict x, const unsigned char* restrict fixed, int n, double r, int insulated, double* restrict scratch)
+{
+	// Thomas algorithm: eliminate below the diagonal going forward, then substitute going backward
+	for(int k = 0; k < n; k++)
+	{
+		double below = 0.0;
+		double diagonal = 1.0;
+		double above = 0.0;
+		if(!fixed[k])
+		{
+			below = (k > 0) ? -r : 0.0;
+			above = (k < n - 1) ? -r : 0.0;
+			diagonal = (insulated && (k == 0 || k == n - 1)) ? 1.0 + r : 1.0 + 2.0 * r;
+		}
+		if(k > 0)
+		{
+			diagonal -= below * scratch[k - 1];
+			x[k] -= below * x[k - 1];
+		}
+		scratch[k] = above / diagonal;
+		x[k] /= diagonal;
+	}
+	for(int k = n - 2; k >= 0; k--)
+	{
+		x[k] -= scratch[k] * x[k + 1];
+	}
+}
+
+/**
+ * @brief Sends the blocks of row_blocks and rebuilds the whole columns of this MPI process from the blocks received.
+ **/
+static void transpose_to_columns(struct adi* adi, const struct slab* slab)
+{
+	MPI_Alltoallv(adi->row_blocks, adi->row_block_counts, adi->row_block_offsets, MPI_DOUBLE, adi->column_blocks, adi->column_block_counts, adi->column_block_offsets, MPI_DOUBLE, slab->comm);
+	const int my_columns = adi->column_counts[slab->my_rank];
+	#pragma omp parallel for
+	for(int k = 0; k < my_columns; k++)
+	{
+		for(int p = 0; p < slab->comm_size; p++)
+		{
+			const int rows = slab->cell_counts[p] / slab->columns;
+			const int first_row = slab->cell_offsets[p] / slab->columns;
+			memcpy(&adi->columns[(size_t)k * slab->total_rows + first_row], &adi->column_blocks[adi->column_block_offsets[p] + (size_t)k * rows], rows * sizeof(double));
+		}
+	}
+}
+
+/**
+ * @brief Splits the whole columns of this MPI process into blocks and sends them back, so that row_blocks holds the blocks of the rows of this MPI process.
+ **/
+static void transpose_to_rows(struct adi* adi, const struct slab* slab)
+{
+	const int my_columns = adi->column_counts[slab->my_rank];
+	#pragma omp parallel for
+	for(int k = 0; k < my_columns; k++)
+	{
+		for(int p = 0; p < slab->comm_size; p++)
+		{
+			const int rows = slab->cell_counts[p] / slab->columns;
+			const int first_row = slab->cell_offsets[p] / slab->columns;
+			memcpy(&adi->column_blocks[adi->column_block_offsets[p] + (size_t)k * rows], &adi->columns[(size_t)k * slab->total_rows + first_row], rows * sizeof(double));
+		}
+	}
+	MPI_Alltoallv(adi->column_blocks, adi->column_block_counts, adi->column_block_offsets, MPI_DOUBLE, adi->row_blocks, adi->row_block_counts, adi->row_block_offsets, MPI_DOUBLE, slab->comm);
+}
+
+/**
+ * @brief Returns where a cell of the slab goes in row_blocks.
+ **/
+static inline size_t row_block_index(const struct adi* adi, const struct slab* slab, int p, int i, int j)
+{
+	return adi->row_block_offsets[p] + (size_t)(j - adi->first_columns[p]) * slab->rows + i;
+}
+
+int adi_create(struct adi* adi, const struct slab* slab, double time_step)
+{
+	memset(adi, 0, sizeof(*adi));
+	adi->half_step = 0.5 * (0.25 * time_step);
+
+	const int comm_size = slab->comm_size;
+	adi->column_counts = malloc(comm_size * sizeof(int));
+	adi->first_columns = malloc(comm_size * sizeof(int));
+	adi->row_block_counts = malloc(comm_size * sizeof(int));
+	adi->row_block_offsets = malloc(comm_size * sizeof(int));
+	adi->column_block_counts = malloc(comm_size * sizeof(int));
+	adi->column_block_offsets = malloc(comm_size * sizeof(int));
+	int allocated = adi->column_counts != NULL && adi->first_columns != NULL && adi->row_block_counts != NULL && adi->row_block_offsets != NULL && adi->column_block_counts != NULL && adi->column_block_offsets != NULL;
+	MPI_Allreduce(MPI_IN_PLACE, &allocated, 1, MPI_INT, MPI_MIN, slab->comm);
+	if(!allocated)
+	{
+		adi_destroy(adi);
+		return -1;
+	}
+
+	// The columns are split like the rows: the first C % P MPI processes get one column more than the others
+	for(int p = 0, first_column = 0; p < comm_size; p++)
+	{
+		adi->column_counts[p] = slab->columns / comm_size + (p < slab->columns % comm_size ? 1 : 0);
+		adi->first_columns[p] = first_column;
+		first_column += adi->column_counts[p];
+	}
+	const int my_columns = slab->columns / comm_size + (slab->my_rank < slab->columns % comm_size ? 1 : 0);
+	for(int p = 0, row_offset = 0, column_offset = 0; p < comm_size; p++)
+	{
+		adi->row_block_counts[p] = slab->rows * adi->column_counts[p];
+		adi->row_block_offsets[p] = row_offset;
+		row_offset += adi->row_block_counts[p];
+		adi->column_block_counts[p] = slab->cell_counts[p] / slab->columns * my_columns;
+		adi->column_block_offsets[p] = column_offset;
+		column_offset += adi->column_block_counts[p];
+	}
+
+	const size_t column_cells = (size_t)slab->total_rows * my_columns;
+	adi->scratch_length = (slab->total_rows > slab->columns) ? slab->total_rows : slab->columns;
+	adi->row_blocks = malloc((size_t)slab->rows * slab->columns * sizeof(double));
+	adi->column_blocks = malloc(column_cells * sizeof(double));
+	adi->columns = malloc(column_cells * sizeof(double));
+	adi->fixed_columns = malloc(column_cells);
+	adi->scratch = malloc((size_t)omp_get_max_threads() * adi->scratch_length * sizeof(double));
+	allocated = adi->row_blocks != NULL && adi->column_blocks != NULL && adi->columns != NULL && adi->fixed_columns != NULL && adi->scratch != NULL;
+	MPI_Allreduce(MPI_IN_PLACE, &allocated, 1, MPI_INT, MPI_MIN, slab->comm);
+	if(!allocated)
+	{
+		adi_destroy(adi);
+		return -1;
+	}
+
+	// The fixed cells go through the same transpose as the temperatures
+	#pragma omp parallel for
+	for(int i = 0; i < slab->rows; i++)
+	{
+		for(int p = 0; p < comm_size; p++)
+		{
+			for(int j = adi->first_columns[p]; j < adi->first_columns[p] + adi->column_counts[p]; j++)
+			{
+				adi->row_blocks[row_block_index(adi, slab, p, i, j)] = slab->fixed[(size_t)i * slab->columns + j];
+			}
+		}
+	}
+	transpose_to_columns(adi, slab);
+	for(size_t cell = 0; cell < column_cells; cell++)
+	{
+		adi->fixed_columns[cell] = adi->columns[cell] != 0.0;
+	}
+	return 0;
+}
+
+double adi_step(struct adi* adi, struct slab* slab)
+{
+	const int columns = slab->columns;
+	const double r = adi->half_step;
+	slab_exchange_ghost_rows(slab, slab->temperatures_last);
+
+	// First half, implicit along rows: every row is solved where it is, then the right-hand side of the second half is sent in blocks
+	#pragma omp parallel
+	{
+		double* scratch = &adi->scratch[(size_t)omp_get_thread_num() * adi->scratch_length];
+		#pragma omp for
+		for(int i = 0; i < slab->rows; i++)
+		{
+			const double* up = &slab->temperatures_last[(size_t)i * columns];
+			const double* last = &slab->temperatures_last[(size_t)(i + 1) * columns];
+			const double* down = &slab->temperatures_last[(size_t)(i + 2) * columns];
+			double* half = &slab->temperatures[(size_t)(i + 1) * columns];
+			const unsigned char* fixed = &slab->fixed[(size_t)i * columns];
+
+			for(int j = 0; j < columns; j++)
+			{
+				half[j] = fixed[j] ? last[j] : last[j] + r * (up[j] - 2.0 * last[j] + down[j]);
+			}
+			solve_line(half, fixed, columns, r, 1, scratch);
+
+			for(int p = 0; p < slab->comm_size; p++)
+			{
+				for(int j = adi->first_columns[p]; j < adi->first_columns[p] + adi->column_counts[p]; j++)
+				{
+					double along_row = (j == 0) ? half[1] - half[0]
+					                 : (j == columns - 1) ? half[j - 1] - half[j]
+					                 : half[j - 1] - 2.0 * half[j] + half[j + 1];
+					adi->row_blocks[row_block_index(adi, slab, p, i, j)] = fixed[j] ? half[j] : half[j] + r * along_row;
+				}
+			}
+		}
+	}
+
+	// Second half, implicit along columns, on whole columns
+	transpose_to_columns(adi, slab);
+	#pragma omp parallel
+	{
+		double* scratch = &adi->scratch[(size_t)omp_get_thread_num() * adi->scratch_length];
+		#pragma omp for
+		for(int k = 0; k < adi->column_counts[slab->my_rank]; k++)
+		{
+			solve_line(&adi->columns[(size_t)k * slab->total_rows], &adi->fixed_columns[(size_t)k * slab->total_rows], slab->total_rows, r, 0, scratch);
+		}
+	}
+	transpose_to_rows(adi, slab);
+
+	double my_temperature_change = 0.0;
+	#pragma omp parallel for reduction(max:my_temperature_change)
+	for(int i = 0; i < slab->rows; i++)
+	{
+		const double* last = &slab->temperatures_last[(size_t)(i + 1) * columns];
+		double* current = &slab->temperatures[(size_t)(i + 1) * columns];
+		for(int p = 0; p < slab->comm_size; p++)
+		{
+			for(int j = adi->first_columns[p]; j < adi->first_columns[p] + adi->column_counts[p]; j++)
+			{
+				current[j] = adi->row_blocks[row_block_index(adi, slab, p, i, j)];
+				my_temperature_change = fmax(fabs(current[j] - last[j]), my_temperature_change);
+			}
+		}
+	}
+	return my_temperature_change;
+}
+
+void adi_destroy(struct adi* adi)
+{
+	free(adi->column_counts);
+	free(adi->first_columns);
+	free(adi->row_block_counts);
+	free(adi->row_block_offsets);
+	free(adi->column_block_counts);
+	free(adi->column_block_offsets);
+	free(adi->row_blocks);
+	free(adi->column_blocks);
+	free(adi->columns);
+	free(adi->fixed_columns);
+	free(adi->scratch);
+	memset(adi, 0, sizeof(*adi));
+}
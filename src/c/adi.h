@@ -0,0 +1,73 @@
+/**
+ * @file adi.h
+ * @brief Peaceman-Rachford alternating-direction implicit time stepping, an alternative to the Jacobi iteration for long transients.
+ * @details The explicit update of the Jacobi iteration cannot move heat by more than a cell per iteration. ADI splits the Laplacian L into its part along rows Lx and its part along columns Ly, and advances the plate by a time step tau in two halves, each implicit in one direction:
+ * (I - tau / 2 Lx) t* = (I + tau / 2 Ly) t, then (I - tau / 2 Ly) t' = (I + tau / 2 Lx) t*.
+ * Every half is a set of independent tridiagonal systems, one per row or per column, and is stable whatever tau. The left and right edges are insulated and the rows beyond the top and bottom of the plate are at 0, as in the Jacobi iteration; sources keep their temperature.
+ * Rows are whole in every slab, so the row systems are solved locally. For the column systems, the plate is transposed with MPI_Alltoallv so that every MPI process holds whole columns, then transposed back.
+ * Time is counted in Jacobi iterations: away from the edges, a Jacobi iteration is an explicit step of tau = 1 / 4.
+ **/
+
+#ifndef ADI_H_INCLUDED
+#define ADI_H_INCLUDED
+
+#include "slab.h"
+
+/**
+ * @brief The column decomposition of a plate and the buffers of the transposes.
+ **/
+struct adi
+{
+	/// tau / 2, the weight of the neighbours in both halves.
+	double half_step;
+	/// On every MPI process: the number of columns held by each MPI process after the transpose.
+	int* column_counts;
+	/// On every MPI process: the index of the first column held by each MPI process after the transpose.
+	int* first_columns;
+	/// The number of cells sent to each MPI process by the transpose from rows to columns, received from each by the transpose back.
+	int* row_block_counts;
+	/// The offset of the block of each MPI process in row_blocks.
+	int* row_block_offsets;
+	/// The number of cells received from each MPI process by the transpose from rows to columns, sent to each by the transpose back.
+	int* column_block_counts;
+	/// The offset of the block of each MPI process in column_blocks.
+	int* column_block_offsets;
+	/// The blocks of the rows of this MPI process, one per MPI process, each column after column.
+	double* row_blocks;
+	/// The blocks of the columns of this MPI process, one per MPI process, each column after column.
+	double* column_blocks;
+	/// The columns of this MPI process, whole, one after the other.
+	double* columns;
+	/// Whether each cell of columns is a fixed source.
+	unsigned char* fixed_columns;
+	/// Scratch for the tridiagonal solves, one line per OpenMP thread.
+	double* scratch;
+	/// The length of a line of scratch.
+	int scratch_length;
+};
+
+/**
+ * @brief Builds the column decomposition and transposes the fixed cells.
+ * @details This is a collective operation, to make once the plate has been scattered and its fixed cells are known.
+ * @param[out] adi The state to initialise.
+ * @param[in] slab The slab.
+ * @param[in] time_step The time step, in Jacobi iterations.
+ * @return 0 on success, -1 on every MPI process if the memory cannot be allocated on one of them.
+ **/
+int adi_create(struct adi* adi, const struct slab* slab, double time_step);
+
+/**
+ * @brief Advances the plate by one time step.
+ * @details This is a collective operation. The temperatures at the end of the step are written in slab->temperatures from slab->temperatures_last, like heat_propagate.
+ * @param[in,out] adi The state of the time stepping.
+ * @param[in,out] slab The slab.
+ * @return The maximum absolute temperature change of the step in the slab.
+ **/
+double adi_step(struct adi* adi, struct slab* slab);
+
+/**
+ * @brief Releases the memory of the column decomposition.
+ **/
+void adi_destroy(struct adi* adi);
+
+#endif
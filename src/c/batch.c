@@ -0,0 +1,140 @@
+/**
+ * @file batch.c
+ * @brief Job lists run by a single launch of the CPU version.
+ **/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <mpi.h>
+
+#include "batch.h"
+
+/**
+ * @brief Reads an entire file into a null-terminated string.
+ * @return The content, or NULL if the file cannot be read.
+ **/
+static char* read_file(const char* path, long* length)
+{
+	FILE* file = fopen(path, "r");
+	if(file == NULL)
+	{
+		return NULL;
+	}
+	char* text = NULL;
+	if(fseek(file, 0, SEEK_END) == 0 && (*length = ftell(file)) >= 0 && fseek(file, 0, SEEK_SET) == 0)
+	{
+		text = malloc(*length + 1);
+		if(text != NULL && fread(text, 1, *length, file) != (size_t)*length)
+		{
+			free(text);
+			text = NULL;
+		}
+	}
+	fclose(file);
+	if(text != NULL)
+	{
+		text[*length] = '\0';
+	}
+	return text;
+}
+
+int batch_load(struct batch* batch, const char* path, int root, MPI_Comm comm)
+{
+	memset(batch, 0, sizeof(*batch));
+	int my_rank;
+	MPI_Comm_rank(comm, &my_rank);
+
+	// A length of -1 tells everybody that the file cannot be read
+	long length = -1;
+	if(my_rank == root)
+	{
+		batch->text = read_file(path, &length);
+		if(batch->text == NULL)
+		{
+			length = -1;
+		}
+	}
+	MPI_Bcast(&length, 1, MPI_LONG, root, comm);
+	if(length < 0 || length >= (long)INT_MAX)
+	{
+		free(batch->text);
+		batch->text = NULL;
+		return -1;
+	}
+	if(my_rank != root)
+	{
+		batch->text = malloc(length + 1);
+		if(batch->text == NULL)
+		{
+			MPI_Abort(comm, EXIT_FAILURE);
+		}
+	}
+	MPI_Bcast(batch->text, (int)length + 1, MPI_CHAR, root, comm);
+
+	// Every line is cut where it ends; the lines with something else than a comment are the jobs
+	int capacity = 0;
+	for(char* line = strtok(batch->text, "\n"); line != NULL; line = strtok(NULL, "\n"))
+	{
+		char* first = line + strspn(line, " \t\r");
+		if(*first == '\0' || *first == '#')
+		{
+			continue;
+		}
+		if(batch->count == capacity)
+		{
+			capacity = capacity ? capacity * 2 : 16;
+			char** jobs = realloc(batch->jobs, capacity * sizeof(char*));
+			if(jobs == NULL)
+			{
+				MPI_Abort(comm, EXIT_FAILURE);
+			}
+			batch->jobs = jobs;
+		}
+		batch->jobs[batch->count++] = first;
+	}
+	if(batch->count == 0)
+	{
+		batch_free(batch);
+		return -1;
+	}
+	return 0;
+}
+
+void batch_free(struct batch* batch)
+{
+	free(batch->text);
+	free(batch->jobs);
+	memset(batch, 0, sizeof(*batch));
+}
+
+int batch_job_create(struct batch_job* job, const char* line, int argc, char* argv[])
+{
+	memset(job, 0, sizeof(*job));
+	job->words = strdup(line);
+	// A job cannot have more words than half its characters, plus one
+	job->argv = malloc((argc + strlen(line) / 2 + 2) * sizeof(char*));
+	if(job->words == NULL || job->argv == NULL)
+	{
+		batch_job_destroy(job);
+		return -1;
+	}
+	for(job->argc = 0; job->argc < argc; job->argc++)
+	{
+		job->argv[job->argc] = argv[job->argc];
+	}
+	for(char* word = strtok(job->words, " \t\r"); word != NULL; word = strtok(NULL, " \t\r"))
+	{
+		job->argv[job->argc++] = word;
+	}
+	job->argv[job->argc] = NULL;
+	return 0;
+}
+
+void batch_job_destroy(struct batch_job* job)
+{
+	free(job->words);
+	free(job->argv);
+	memset(job, 0, sizeof(*job));
+}
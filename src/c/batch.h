@@ -0,0 +1,69 @@
+/**
+ * @file batch.h
+ * @brief Job lists run by a single launch of the CPU version, see --batch.
+ * @details A job list is a text file with one job per line: the options of the job, separated by spaces, as they would be given on the command line. Blank lines and lines starting with '#' are ignored; options cannot contain spaces since there is no quoting. The options of a job come after those of the command line, so the command line gives the defaults that a job overrides.
+ **/
+
+#ifndef BATCH_H_INCLUDED
+#define BATCH_H_INCLUDED
+
+#include <mpi.h>
+
+/**
+ * @brief The jobs of a job list.
+ **/
+struct batch
+{
+	/// The content of the file, each job terminated by a null character.
+	char* text;
+	/// The jobs, pointing into the text, without their leading blanks.
+	char** jobs;
+	/// The number of jobs.
+	int count;
+};
+
+/**
+ * @brief The arguments with which a job is parsed.
+ **/
+struct batch_job
+{
+	/// The number of arguments.
+	int argc;
+	/// The arguments of the command line followed by those of the job, NULL-terminated.
+	char** argv;
+	/// The words of the job, which the arguments of the job point to.
+	char* words;
+};
+
+/**
+ * @brief Loads a job list, read by one MPI process and broadcast to the others.
+ * @details This is a collective operation.
+ * @param[out] batch The jobs.
+ * @param[in] path The path of the job list.
+ * @param[in] root The rank of the MPI process that reads the file.
+ * @param[in] comm The communicator.
+ * @return 0 on success, -1 on every MPI process if the file cannot be read or contains no job.
+ **/
+int batch_load(struct batch* batch, const char* path, int root, MPI_Comm comm);
+
+/**
+ * @brief Releases the memory of a job list.
+ **/
+void batch_free(struct batch* batch);
+
+/**
+ * @brief Builds the arguments of a job.
+ * @param[out] job The arguments.
+ * @param[in] line The job, as found in the job list.
+ * @param[in] argc The number of arguments of the command line, as received by main.
+ * @param[in] argv The arguments of the command line, as received by main.
+ * @return 0 on success, -1 if the memory cannot be allocated.
+ **/
+int batch_job_create(struct batch_job* job, const char* line, int argc, char* argv[]);
+
+/**
+ * @brief Releases the memory of the arguments of a job.
+ **/
+void batch_job_destroy(struct batch_job* job);
+
+#endif
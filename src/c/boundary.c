@@ -0,0 +1,216 @@
+/**
+ * @file boundary.c
+ * @brief The conditions at the edges of the plate.
+ **/
+
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include "boundary.h"
+
+void boundary_default(struct boundary* boundary)
+{
+	boundary->modes[BOUNDARY_TOP] = BOUNDARY_FIXED;
+	boundary->modes[BOUNDARY_BOTTOM] = BOUNDARY_FIXED;
+	boundary->modes[BOUNDARY_LEFT] = BOUNDARY_INSULATED;
+	boundary->modes[BOUNDARY_RIGHT] = BOUNDARY_INSULATED;
+	for(int edge = 0; edge < BOUNDARY_EDGES; edge++)
+	{
+		boundary->values[edge] = 0.0;
+	}
+}
+
+int boundary_is_default(const struct boundary* boundary)
+{
+	struct boundary original;
+	boundary_default(&original);
+	for(int edge = 0; edge < BOUNDARY_EDGES; edge++)
+	{
+		if(boundary->modes[edge] != original.modes[edge] || (boundary->modes[edge] == BOUNDARY_FIXED && boundary->values[edge] != original.values[edge]))
+		{
+			return 0;
+		}
+	}
+	return 1;
+}
+
+/**
+ * @brief Parses an item of a specification, EDGE=MODE.
+ * @return 0 on success, -1 if the item is not understood.
+ **/
+static int parse_item(struct boundary* boundary, const char* item, size_t length)
+{
+	static const char* edge_names[BOUNDARY_EDGES] = {"top", "bottom", "left", "right"};
+	const char* equals = memchr(item, '=', length);
+	if(equals == NULL)
+	{
+		return -1;
+	}
+	const size_t name_length = equals - item;
+	const char* mode = equals + 1;
+	const size_t mode_length = length - name_length - 1;
+
+	enum boundary_mode parsed_mode;
+	double value = 0.0;
+	if(mode_length == 9 && strncmp(mode, "insulated", 9) == 0)
+	{
+		parsed_mode = BOUNDARY_INSULATED;
+	}
+	else if(mode_length == 8 && strncmp(mode, "periodic", 8) == 0)
+	{
+		parsed_mode = BOUNDARY_PERIODIC;
+	}
+	else if(mode_length >= 5 && strncmp(mode, "fixed", 5) == 0)
+	{
+		parsed_mode = BOUNDARY_FIXED;
+		if(mode_length > 5)
+		{
+			char* end;
+			value = strtod(mode + 6, &end);
+			if(mode[5] != ':' || end != mode + mode_length || end == mode + 6 || !isfinite(value))
+			{
+				return -1;
+			}
+		}
+	}
+	else
+	{
+		return -1;
+	}
+
+	int matched = 0;
+	for(int edge = 0; edge < BOUNDARY_EDGES; edge++)
+	{
+		if((name_length == 3 && strncmp(item, "all", 3) == 0) || (name_length == strlen(edge_names[edge]) && strncmp(item, edge_names[edge], name_length) == 0))
+		{
+			boundary->modes[edge] = parsed_mode;
+			boundary->values[edge] = value;
+			matched = 1;
+		}
+	}
+	return matched ? 0 : -1;
+}
+
+int boundary_parse(struct boundary* boundary, const char* specification)
+{
+	const char* item = specification;
+	while(1)
+	{
+		const char* comma = strchr(item, ',');
+		const size_t length = (comma != NULL) ? (size_t)(comma - item) : strlen(item);
+		if(parse_item(boundary, item, length) != 0)
+		{
+			return -1;
+		}
+		if(comma == NULL)
+		{
+			break;
+		}
+		item = comma + 1;
+	}
+
+	// An edge cannot wrap around to an edge that does not
+	if((boundary->modes[BOUNDARY_TOP] == BOUNDARY_PERIODIC) != (boundary->modes[BOUNDARY_BOTTOM] == BOUNDARY_PERIODIC) ||
+	   (boundary->modes[BOUNDARY_LEFT] == BOUNDARY_PERIODIC) != (boundary->modes[BOUNDARY_RIGHT] == BOUNDARY_PERIODIC))
+	{
+		return -1;
+	}
+	return 0;
+}
+
+void boundary_link(const struct boundary* boundary, struct slab* slab)
+{
+	const int periodic = boundary->modes[BOUNDARY_TOP] == BOUNDARY_PERIODIC;
+	const int last_rank = slab->comm_size - 1;
+	slab->up_neighbour_rank = (slab->my_rank > 0) ? slab->my_rank - 1 : periodic ? last_rank : MPI_PROC_NULL;
+	slab->down_neighbour_rank = (slab->my_rank < last_rank) ? slab->my_rank + 1 : periodic ? 0 : MPI_PROC_NULL;
+}
+
+/**
+ * @brief Fills a ghost row at an edge of the plate that is not periodic.
+ * @param[out] ghost The ghost row.
+ * @param[in] inside The row of the plate next to it.
+ **/
+static void fill_ghost_row(double* ghost, const double* inside, int columns, enum boundary_mode mode, double value)
+{
+	if(mode == BOUNDARY_INSULATED)
+	{
+		memcpy(ghost, inside, columns * sizeof(double));
+	}
+	else if(mode == BOUNDARY_FIXED)
+	{
+		for(int j = 0; j < columns; j++)
+		{
+			ghost[j] = value;
+		}
+	}
+}
+
+void boundary_fill_ghost_rows(const struct boundary* boundary, const struct slab* slab, double* temperatures)
+{
+	const int columns = slab->columns;
+	if(slab->first_global_row == 0)
+	{
+		fill_ghost_row(&temperatures[0], &temperatures[columns], columns, boundary->modes[BOUNDARY_TOP], boundary->values[BOUNDARY_TOP]);
+	}
+	if(slab->first_global_row + slab->rows == slab->total_rows)
+	{
+		fill_ghost_row(&temperatures[(size_t)(slab->rows + 1) * columns], &temperatures[(size_t)slab->rows * columns], columns, boundary->modes[BOUNDARY_BOTTOM], boundary->values[BOUNDARY_BOTTOM]);
+	}
+}
+
+/**
+ * @brief Calculates a cell at the left or right end of a row.
+ * @details Neighbours are summed in the order of heat_propagate: the rows above and below, then the left neighbour, then the right one.
+ * @param[in] inner The neighbour within the row.
+ * @param[in] outside The neighbour beyond the edge, ignored if it is insulated.
+ * @param[in] inner_first Whether the neighbour within the row is the left one, that is the cell is on the right edge.
+ **/
+static inline double edge_cell(double before, double after, double inner, double outside, enum boundary_mode mode, int inner_first)
+{
+	if(mode == BOUNDARY_INSULATED)
+	{
+		return (before + after + inner) / 3.0;
+	}
+	return inner_first ? 0.25 * (before + after + inner + outside) : 0.25 * (before + after + outside + inner);
+}
+
+double boundary_propagate(const double* restrict temperatures_last, double* restrict temperatures, int rows, int columns, const struct boundary* boundary)
+{
+	double my_temperature_change = 0.0;
+	const enum boundary_mode left_mode = boundary->modes[BOUNDARY_LEFT];
+	const enum boundary_mode right_mode = boundary->modes[BOUNDARY_RIGHT];
+	const int end = columns - 1;
+
+	#pragma omp parallel for reduction(max:my_temperature_change)
+	for(int i = 1; i <= rows; i++)
+	{
+		const double* restrict before = &temperatures_last[(size_t)(i - 1) * columns];
+		const double* restrict last = &temperatures_last[(size_t)i * columns];
+		const double* restrict after = &temperatures_last[(size_t)(i + 1) * columns];
+		double* restrict current = &temperatures[(size_t)i * columns];
+
+		// The cells beyond the left and right edges are the other end of the row when periodic, the fixed value otherwise
+		const double left_outside = (left_mode == BOUNDARY_PERIODIC) ? last[end] : boundary->values[BOUNDARY_LEFT];
+		const double right_outside = (right_mode == BOUNDARY_PERIODIC) ? last[0] : boundary->values[BOUNDARY_RIGHT];
+
+		// Process the cell on the left edge
+		current[0] = (last[0] == MAX_TEMPERATURE) ? MAX_TEMPERATURE : edge_cell(before[0], after[0], last[1], left_outside, left_mode, 0);
+		my_temperature_change = fmax(fabs(current[0] - last[0]), my_temperature_change);
+
+		// Process all cells between the first and last ones excluded, which each has four neighbours
+		#pragma omp simd reduction(max:my_temperature_change)
+		for(int j = 1; j < end; j++)
+		{
+			current[j] = (last[j] == MAX_TEMPERATURE) ? MAX_TEMPERATURE : 0.25 * (before[j] + after[j] + last[j - 1] + last[j + 1]);
+			my_temperature_change = fmax(fabs(current[j] - last[j]), my_temperature_change);
+		}
+
+		// Process the cell on the right edge
+		current[end] = (last[end] == MAX_TEMPERATURE) ? MAX_TEMPERATURE : edge_cell(before[end], after[end], last[end - 1], right_outside, right_mode, 1);
+		my_temperature_change = fmax(fabs(current[end] - last[end]), my_temperature_change);
+	}
+
+	return my_temperature_change;
+}
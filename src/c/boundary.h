@@ -0,0 +1,93 @@
+/**
+ * @file boundary.h
+ * @brief The conditions at the edges of the plate, see --boundary.
+ * @details Every edge of the plate has its own mode:
+ * - fixed: the cells beyond the edge are held at a value, 0 unless given; the default at the top and bottom, where the ghost rows of the plate stay at 0;
+ * - insulated: no heat crosses the edge; the default on the left and right, where a cell averages the 3 neighbours it has. At the top and bottom, the ghost row mirrors the row inside the plate instead, so that a cell there averages 4 values, itself among them. The top and bottom go through the ghost rows so that the kernel needs no test on them; a mirrored row is the only thing a ghost row can hold that conducts nothing across the edge, and it cannot drop a neighbour from the count. Both rules share their steady state, since T = (T + a + b + c) / 4 is T = (a + b + c) / 3, but the mirrored cell moves a quarter less per iteration, so the transient temperatures differ;
+ * - periodic: the edge wraps around to the opposite one, which must then be periodic too.
+ * The top and bottom conditions go through the ghost rows: periodic ones link the first and last MPI processes into a ring, so that the usual exchange fills them, and the others are filled after the exchange, one row at a time. The left and right conditions go through the cells at both ends of every row, which the kernel processes apart from the others already, so the loop over the cells inside the plate is that of heat_propagate and has no test on the boundaries.
+ **/
+
+#ifndef BOUNDARY_H_INCLUDED
+#define BOUNDARY_H_INCLUDED
+
+#include "slab.h"
+
+/**
+ * @brief The edges of the plate.
+ **/
+enum boundary_edge
+{
+	BOUNDARY_TOP,
+	BOUNDARY_BOTTOM,
+	BOUNDARY_LEFT,
+	BOUNDARY_RIGHT,
+	BOUNDARY_EDGES
+};
+
+/**
+ * @brief The conditions an edge can have.
+ **/
+enum boundary_mode
+{
+	BOUNDARY_FIXED,
+	BOUNDARY_INSULATED,
+	BOUNDARY_PERIODIC
+};
+
+/**
+ * @brief The conditions at all edges of the plate.
+ **/
+struct boundary
+{
+	/// The condition at every edge, indexed by enum boundary_edge.
+	enum boundary_mode modes[BOUNDARY_EDGES];
+	/// The value beyond every fixed edge.
+	double values[BOUNDARY_EDGES];
+};
+
+/**
+ * @brief Sets the conditions of the original code: fixed at 0 at the top and bottom, insulated on the left and right.
+ **/
+void boundary_default(struct boundary* boundary);
+
+/**
+ * @brief Tells whether the conditions are those of the original code.
+ **/
+int boundary_is_default(const struct boundary* boundary);
+
+/**
+ * @brief Changes conditions from a specification, a list of EDGE=MODE separated by commas.
+ * @details EDGE is top, bottom, left, right or all; MODE is fixed, fixed:VALUE, insulated or periodic. Later items override earlier ones.
+ * @param[in,out] boundary The conditions, changed only for the edges the specification gives.
+ * @param[in] specification The specification.
+ * @return 0 on success, -1 if the specification is not understood or makes an edge periodic without the opposite one.
+ **/
+int boundary_parse(struct boundary* boundary, const char* specification);
+
+/**
+ * @brief Links the first and last MPI processes of a slab if the top and bottom are periodic, so that slab_exchange_ghost_rows fills the ghost rows at the edges of the plate too; unlinks them otherwise.
+ **/
+void boundary_link(const struct boundary* boundary, struct slab* slab);
+
+/**
+ * @brief Fills the ghost rows at the top and bottom of the plate that are not periodic; call after every exchange of the ghost rows.
+ * @param[in] boundary The conditions.
+ * @param[in] slab The slab.
+ * @param[in,out] temperatures A buffer of the slab, ghost rows included.
+ **/
+void boundary_fill_ghost_rows(const struct boundary* boundary, const struct slab* slab, double* temperatures);
+
+/**
+ * @brief Propagates the temperatures of a C slab by one iteration like heat_propagate, with the conditions of the left and right edges.
+ * @details The conditions of the original code give bit for bit the results of heat_propagate.
+ * @param[in] temperatures_last The temperatures at the previous iteration, ghost rows included and filled.
+ * @param[out] temperatures The temperatures at this iteration; ghost rows are not written.
+ * @param[in] rows The number of rows in the slab, ghost rows excluded.
+ * @param[in] columns The number of columns, at least 2.
+ * @param[in] boundary The conditions.
+ * @return The maximum absolute temperature change in the slab.
+ **/
+double boundary_propagate(const double* restrict temperatures_last, double* restrict temperatures, int rows, int columns, const struct boundary* boundary);
+
+#endif
@@ -0,0 +1,251 @@
+/**
+ * @file cg.c
+ * @brief Pipelined preconditioned conjugate gradients.
+ **/
+
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <mpi.h>
+
+#include "cg.h"
+
+/// The number of iterations after which the vectors updated by recurrences are recalculated from their definitions, since rounding errors make them drift from the true ones.
+#define REPLACEMENT_INTERVAL 50
+
+/**
+ * @brief Returns the diagonal of the operator at a column: 3 on the edges, which have three neighbours, 4 elsewhere.
+ **/
+static inline double diagonal(int j, int columns)
+{
+	return (j == 0 || j == columns - 1) ? 3.0 : 4.0;
+}
+
+/**
+ * @brief Calculates d v minus the sum of the neighbours of v at a cell.
+ * @param[in] v The vector, ghost rows included and up to date.
+ * @param[in] i The row of the cell, ghost rows excluded.
+ **/
+static inline double operator_at(const double* v, int i, int j, int columns)
+{
+	const double* current = &v[(size_t)(i + 1) * columns];
+	double neighbours = current[j - columns] + current[j + columns];
+	if(j > 0)
+	{
+		neighbours += current[j - 1];
+	}
+	if(j < columns - 1)
+	{
+		neighbours += current[j + 1];
+	}
+	return diagonal(j, columns) * current[j] - neighbours;
+}
+
+/**
+ * @brief Applies the operator to a vector that is 0 on fixed cells, after exchanging its ghost rows.
+ * @param[in] slab The slab.
+ * @param[in,out] v The vector, ghost rows included.
+ * @param[out] result The operator applied to v, 0 on fixed cells, rows * columns.
+ **/
+static void apply_operator(const struct slab* slab, double* v, double* result)
+{
+	const int columns = slab->columns;
+	slab_exchange_ghost_rows(slab, v);
+	#pragma omp parallel for
+	for(int i = 0; i < slab->rows; i++)
+	{
+		for(int j = 0; j < columns; j++)
+		{
+			const size_t cell = (size_t)i * columns + j;
+			result[cell] = slab->fixed[cell] ? 0.0 : operator_at(v, i, j, columns);
+		}
+	}
+}
+
+/**
+ * @brief Applies the diagonal preconditioner to a vector, writing the result into a buffer with ghost rows.
+ **/
+static void precondition(const struct slab* slab, const double* v, double* with_ghost_rows)
+{
+	const int columns = slab->columns;
+	#pragma omp parallel for
+	for(int i = 0; i < slab->rows; i++)
+	{
+		for(int j = 0; j < columns; j++)
+		{
+			with_ghost_rows[(size_t)(i + 1) * columns + j] = v[(size_t)i * columns + j] / diagonal(j, columns);
+		}
+	}
+}
+
+/**
+ * @brief Allocates a vector of a slab and zeroes each row from the OpenMP thread that will process it.
+ **/
+static double* allocate_vector(const struct slab* slab, int rows)
+{
+	double* vector = malloc((size_t)rows * slab->columns * sizeof(double));
+	if(vector != NULL)
+	{
+		#pragma omp parallel for
+		for(int i = 0; i < rows; i++)
+		{
+			memset(&vector[(size_t)i * slab->columns], 0, slab->columns * sizeof(double));
+		}
+	}
+	return vector;
+}
+
+/**
+ * @brief Copies a vector into the buffer with ghost rows and applies the operator to it.
+ **/
+static void apply_operator_to(const struct slab* slab, const double* v, double* with_ghost_rows, double* result)
+{
+	memcpy(&with_ghost_rows[slab->columns], v, (size_t)slab->rows * slab->columns * sizeof(double));
+	apply_operator(slab, with_ghost_rows, result);
+}
+
+/**
+ * @brief Calculates the residual of the temperatures, and every vector derived from the residual and from the direction, from their definitions; then the local dot products of the next iteration.
+ **/
+static void replace_residual(struct cg* cg, struct slab* slab)
+{
+	// r = b - A t is the sum of the neighbours minus d t, sources and ghost rows of the plate included
+	const int columns = slab->columns;
+	const int count = slab->rows * columns;
+	slab_exchange_ghost_rows(slab, slab->temperatures_last);
+	#pragma omp parallel for
+	for(int i = 0; i < slab->rows; i++)
+	{
+		for(int j = 0; j < columns; j++)
+		{
+			const size_t cell = (size_t)i * columns + j;
+			cg->residual[cell] = slab->fixed[cell] ? 0.0 : -operator_at(slab->temperatures_last, i, j, columns);
+			cg->preconditioned[cell] = cg->residual[cell] / diagonal(j, columns);
+		}
+	}
+	apply_operator_to(slab, cg->preconditioned, cg->next_preconditioned, cg->operator_preconditioned);
+
+	// s = A p, q = M^-1 s, z = A q
+	apply_operator_to(slab, cg->direction, cg->next_preconditioned, cg->s);
+	#pragma omp parallel for
+	for(int i = 0; i < count; i++)
+	{
+		cg->q[i] = cg->s[i] / diagonal(i % columns, columns);
+	}
+	apply_operator_to(slab, cg->q, cg->next_preconditioned, cg->z);
+
+	double gamma = 0.0;
+	double delta = 0.0;
+	#pragma omp parallel for reduction(+:gamma, delta)
+	for(int i = 0; i < count; i++)
+	{
+		gamma += cg->residual[i] * cg->preconditioned[i];
+		delta += cg->operator_preconditioned[i] * cg->preconditioned[i];
+	}
+	cg->dot_products[0] = gamma;
+	cg->dot_products[1] = delta;
+}
+
+int cg_create(struct cg* cg, struct slab* slab)
+{
+	memset(cg, 0, sizeof(*cg));
+	double** vectors[] = {&cg->residual, &cg->preconditioned, &cg->operator_preconditioned, &cg->next_operator_preconditioned, &cg->z, &cg->q, &cg->s, &cg->direction};
+	for(size_t k = 0; k < sizeof(vectors) / sizeof(vectors[0]); k++)
+	{
+		*vectors[k] = allocate_vector(slab, slab->rows);
+	}
+	cg->next_preconditioned = allocate_vector(slab, slab->rows + 2);
+	int allocated = cg->next_preconditioned != NULL;
+	for(size_t k = 0; k < sizeof(vectors) / sizeof(vectors[0]); k++)
+	{
+		allocated = allocated && *vectors[k] != NULL;
+	}
+	MPI_Allreduce(MPI_IN_PLACE, &allocated, 1, MPI_INT, MPI_MIN, slab->comm);
+	if(!allocated)
+	{
+		cg_destroy(cg);
+		return -1;
+	}
+
+	// The direction starts at 0, so the recurrences derived from it do too
+	replace_residual(cg, slab);
+	return 0;
+}
+
+double cg_iterate(struct cg* cg, struct slab* slab)
+{
+	const int columns = slab->columns;
+	const int count = slab->rows * columns;
+
+	// Both dot products are reduced at once while m = M^-1 w and n = A m are calculated
+	double dot_products[2];
+	MPI_Request request;
+	MPI_Iallreduce(cg->dot_products, dot_products, 2, MPI_DOUBLE, MPI_SUM, slab->comm, &request);
+	precondition(slab, cg->operator_preconditioned, cg->next_preconditioned);
+	apply_operator(slab, cg->next_preconditioned, cg->next_operator_preconditioned);
+	MPI_Wait(&request, MPI_STATUS_IGNORE);
+
+	const double gamma = dot_products[0];
+	const double delta = dot_products[1];
+	double alpha = 0.0;
+	double beta = 0.0;
+	if(gamma > 0.0)
+	{
+		if(cg->iteration == 0)
+		{
+			alpha = gamma / delta;
+		}
+		else
+		{
+			beta = gamma / cg->gamma_last;
+			alpha = gamma / (delta - beta * gamma / cg->alpha_last);
+		}
+	}
+	cg->gamma_last = gamma;
+	cg->alpha_last = alpha;
+	cg->iteration++;
+
+	// Every recurrence and both dot products of the next iteration in one pass
+	double my_temperature_change = 0.0;
+	double next_gamma = 0.0;
+	double next_delta = 0.0;
+	#pragma omp parallel for reduction(max:my_temperature_change) reduction(+:next_gamma, next_delta)
+	for(int i = 0; i < count; i++)
+	{
+		const double m = cg->next_preconditioned[columns + i];
+		cg->z[i] = cg->next_operator_preconditioned[i] + beta * cg->z[i];
+		cg->q[i] = m + beta * cg->q[i];
+		cg->s[i] = cg->operator_preconditioned[i] + beta * cg->s[i];
+		cg->direction[i] = cg->preconditioned[i] + beta * cg->direction[i];
+		const double change = alpha * cg->direction[i];
+		slab->temperatures_last[columns + i] += change;
+		cg->residual[i] -= alpha * cg->s[i];
+		cg->preconditioned[i] -= alpha * cg->q[i];
+		cg->operator_preconditioned[i] -= alpha * cg->z[i];
+		my_temperature_change = fmax(fabs(change), my_temperature_change);
+		next_gamma += cg->residual[i] * cg->preconditioned[i];
+		next_delta += cg->operator_preconditioned[i] * cg->preconditioned[i];
+	}
+	cg->dot_products[0] = next_gamma;
+	cg->dot_products[1] = next_delta;
+
+	if(cg->iteration % REPLACEMENT_INTERVAL == 0)
+	{
+		replace_residual(cg, slab);
+	}
+	return my_temperature_change;
+}
+
+void cg_destroy(struct cg* cg)
+{
+	free(cg->residual);
+	free(cg->preconditioned);
+	free(cg->operator_preconditioned);
+	free(cg->next_preconditioned);
+	free(cg->next_operator_preconditioned);
+	free(cg->z);
+	free(cg->q);
+	free(cg->s);
+	free(cg->direction);
+	memset(cg, 0, sizeof(*cg));
+}
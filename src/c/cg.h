@@ -0,0 +1,71 @@
+/**
+ * @file cg.h
+ * @brief Pipelined preconditioned conjugate gradients, an alternative to the Jacobi iteration when only the steady state matters.
+ * @details At the steady state, every cell that is not a source holds the average of its neighbours: d t - (sum of the neighbours) = 0, d being 4, or 3 on the left and right edges. Over the cells that are not sources this is a symmetric positive definite system, the sources and the ghost rows of the plate being known values. Conjugate gradients solve it without storing the matrix, preconditioned by its diagonal.
+ * The pipelined variant of Ghysels and Vanroose reorders the recurrences so that both dot products of an iteration are reduced with a single MPI_Iallreduce, which completes while the preconditioner, the ghost row exchange and the operator of the next direction are computed. It keeps 9 vectors of the size of the slab besides its buffers. The longer recurrences drift further from the vectors they stand for, so every 50 iterations these are recalculated from their definitions.
+ * Dot products are summed in a different order for different decompositions, so unlike the other solvers the results differ across decompositions by rounding errors.
+ **/
+
+#ifndef CG_H_INCLUDED
+#define CG_H_INCLUDED
+
+#include "slab.h"
+
+/**
+ * @brief The state of the conjugate gradients on a slab.
+ * @details The temperatures themselves are the last temperatures of the slab; every other vector is 0 on fixed cells.
+ **/
+struct cg
+{
+	/// The residual r of the temperatures, rows * columns.
+	double* residual;
+	/// The preconditioned residual u.
+	double* preconditioned;
+	/// The operator applied to u: w.
+	double* operator_preconditioned;
+	/// The preconditioner applied to w: m, with ghost rows, (rows + 2) * columns.
+	double* next_preconditioned;
+	/// The operator applied to m: n.
+	double* next_operator_preconditioned;
+	/// The recurrence of n: z.
+	double* z;
+	/// The recurrence of m: q.
+	double* q;
+	/// The recurrence of w: s.
+	double* s;
+	/// The search direction p.
+	double* direction;
+	/// The local parts of (r, u) and (w, u), summed across MPI processes at the next iteration.
+	double dot_products[2];
+	/// (r, u) of the previous iteration overall.
+	double gamma_last;
+	/// The step length of the previous iteration.
+	double alpha_last;
+	/// The number of iterations done.
+	int iteration;
+};
+
+/**
+ * @brief Allocates the vectors and calculates the initial residual of the last temperatures of a slab.
+ * @details This is a collective operation, to make once the plate has been scattered and its fixed cells are known.
+ * @param[out] cg The state to initialise.
+ * @param[in] slab The slab; the ghost rows of its last temperatures are exchanged.
+ * @return 0 on success, -1 on every MPI process if the memory cannot be allocated on one of them.
+ **/
+int cg_create(struct cg* cg, struct slab* slab);
+
+/**
+ * @brief Runs one iteration of the conjugate gradients.
+ * @details This is a collective operation. The temperatures are updated in place in slab->temperatures_last.
+ * @param[in,out] cg The state of the conjugate gradients.
+ * @param[in,out] slab The slab.
+ * @return The maximum absolute temperature change of the iteration in the slab.
+ **/
+double cg_iterate(struct cg* cg, struct slab* slab);
+
+/**
+ * @brief Releases the vectors of the conjugate gradients.
+ **/
+void cg_destroy(struct cg* cg);
+
+#endif
@@ -0,0 +1,84 @@
+/**
+ * @file chebyshev.c
+ * @brief Chebyshev semi-iterative acceleration of the Jacobi iteration.
+ **/
+
+#include <stddef.h>
+#include <math.h>
+
+#include "chebyshev.h"
+
+/**
+ * @brief Extrapolates one cell from its Jacobi value and returns its temperature change.
+ **/
+static inline double extrapolate(double* cell, double last, double target, double omega)
+{
+	*cell += omega * (target - *cell);
+	return fabs(*cell - last);
+}
+
+double chebyshev_sweep(const double* restrict temperatures_last, double* restrict temperatures, const unsigned char* restrict fixed, int rows, int columns, double omega)
+{
+	double my_temperature_change = 0.0;
+
+	#pragma omp parallel for reduction(max:my_temperature_change)
+	for(int i = 1; i <= rows; i++)
+	{
+		const double* restrict up = &temperatures_last[(size_t)(i - 1) * columns];
+		const double* restrict last = &temperatures_last[(size_t)i * columns];
+		const double* restrict down = &temperatures_last[(size_t)(i + 1) * columns];
+		double* restrict current = &temperatures[(size_t)i * columns];
+		const unsigned char* restrict my_fixed = &fixed[(size_t)(i - 1) * columns];
+		const int end = columns - 1;
+
+		// Process the cell on the left edge, which has no left neighbour
+		if(my_fixed[0])
+		{
+			current[0] = last[0];
+		}
+		else
+		{
+			my_temperature_change = fmax(extrapolate(&current[0], last[0], (up[0] + down[0] + last[1]) / 3.0, omega), my_temperature_change);
+		}
+
+		// Process the cells between the edges, which each has four neighbours
+		#pragma omp simd reduction(max:my_temperature_change)
+		for(int j = 1; j < end; j++)
+		{
+			double target = 0.25 * (up[j] + down[j] + last[j - 1] + last[j + 1]);
+			current[j] = my_fixed[j] ? last[j] : current[j] + omega * (target - current[j]);
+			my_temperature_change = fmax(fabs(current[j] - last[j]), my_temperature_change);
+		}
+
+		// Process the cell on the right edge, which has no right neighbour
+		if(my_fixed[end])
+		{
+			current[end] = last[end];
+		}
+		else
+		{
+			my_temperature_change = fmax(extrapolate(&current[end], last[end], (up[end] + down[end] + last[end - 1]) / 3.0, omega), my_temperature_change);
+		}
+	}
+
+	return my_temperature_change;
+}
+
+double chebyshev_spectral_radius(int total_rows)
+{
+	const double pi = acos(-1.0);
+	return 0.5 * (1.0 + cos(pi / (total_rows + 1)));
+}
+
+double chebyshev_omega(int iteration, double rho, double omega_last)
+{
+	if(iteration == 0)
+	{
+		return 1.0;
+	}
+	if(iteration == 1)
+	{
+		return 1.0 / (1.0 - 0.5 * rho * rho);
+	}
+	return 1.0 / (1.0 - 0.25 * rho * rho * omega_last);
+}
@@ -0,0 +1,40 @@
+/**
+ * @file chebyshev.h
+ * @brief Chebyshev semi-iterative acceleration of the Jacobi iteration, an alternative to it when only the steady state matters.
+ * @details Each iteration computes the Jacobi value j of every cell from the last temperatures exactly like heat_propagate, then extrapolates from the temperatures p of the iteration before: p + omega * (j - p). The factors omega follow the Chebyshev recurrence for the spectral radius of the Jacobi iteration, which gives the best polynomial in the Jacobi iteration for that many iterations. The communication pattern is that of the Jacobi iteration: one ghost row exchange per iteration, then a swap of the buffers.
+ **/
+
+#ifndef CHEBYSHEV_H_INCLUDED
+#define CHEBYSHEV_H_INCLUDED
+
+/**
+ * @brief Runs one accelerated Jacobi iteration on a slab.
+ * @param[in] temperatures_last The temperatures at the previous iteration, ghost rows included and up to date.
+ * @param[in,out] temperatures On entry, the temperatures of the iteration before the previous one; on exit, the temperatures at this iteration. Ghost rows are not read nor written.
+ * @param[in] fixed Whether each cell of the slab is a fixed source, rows * columns without ghost rows.
+ * @param[in] rows The number of rows in the slab, ghost rows excluded.
+ * @param[in] columns The number of columns, at least 2.
+ * @param[in] omega The extrapolation factor of this iteration, given by chebyshev_omega.
+ * @return The maximum absolute temperature change from the previous iteration in the slab.
+ **/
+double chebyshev_sweep(const double* restrict temperatures_last, double* restrict temperatures, const unsigned char* restrict fixed, int rows, int columns, double omega);
+
+/**
+ * @brief Estimates the spectral radius of the Jacobi iteration on a plate.
+ * @details The plate is held at 0 above and below, and insulated on the left and right edges; the eigenvalues of the Jacobi iteration then lie in [-rho, rho] with rho = (1 + cos(pi / (rows + 1))) / 2. Sources only hold more cells and lower the actual radius, so this bound is safe for any plate of that many rows.
+ * @param[in] total_rows The number of rows in the plate.
+ * @return The spectral radius.
+ **/
+double chebyshev_spectral_radius(int total_rows);
+
+/**
+ * @brief Calculates the extrapolation factor of an iteration.
+ * @details It is 1 for the first iteration, a plain Jacobi iteration, 1 / (1 - rho^2 / 2) for the second, then 1 / (1 - rho^2 * omega / 4) with omega the factor of the iteration before; it decreases towards 2 / (1 + sqrt(1 - rho^2)).
+ * @param[in] iteration The index of the iteration, from 0.
+ * @param[in] rho The spectral radius of the Jacobi iteration.
+ * @param[in] omega_last The factor of the iteration before, ignored for the first two iterations.
+ * @return The factor of this iteration.
+ **/
+double chebyshev_omega(int iteration, double rho, double omega_last);
+
+#endif
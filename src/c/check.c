@@ -0,0 +1,1093 @@
+/**
+ * @file check.c
+ * @brief Randomised differential testing of the kernels against the serial reference implementation.
+ * @details Every trial builds a random plate: random dimensions, random cells at MAX_TEMPERATURE and random temperatures elsewhere. A candidate may also draw a random setting of its own, such as a layout of sources, from a seed that every MPI process shares so that all of them draw the same. The plate is split across the MPI processes along a random decomposition, each candidate kernel runs a number of iterations on it with the usual ghost row exchanges and random numbers of OpenMP threads, and the result is compared bit for bit with the serial reference implementation, as is the maximum temperature change of every iteration.
+ * Usage: mpirun -np N check [--trials T] [--iterations K] [--seed S]
+ * The exit status is 0 if every trial of every candidate matched the reference, 1 otherwise.
+ **/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <math.h>
+#include <mpi.h>
+#include <omp.h>
+
+#include "kernels.h"
+#include "sor.h"
+#include "chebyshev.h"
+#include "ensemble.h"
+#include "slab.h"
+#include "sources.h"
+#include "conductivity.h"
+#include "heat3d.h"
+#include "boundary.h"
+#include "geometry.h"
+#include "golden.h"
+
+/**
+ * @brief A kernel to check against the reference implementation.
+ **/
+struct candidate
+{
+	/// Name printed in reports.
+	const char* name;
+	/**
+	 * @brief Draws the random setting of a trial on every MPI process, may be NULL.
+	 * @param[in,out] seed The state of the random numbers, the same on every MPI process.
+	 * @param[in] total_rows The number of rows in the plate.
+	 * @param[in,out] columns The number of columns, which the setting may change.
+	 * @return The setting passed to paint, golden and prepare, in a single block released with free.
+	 **/
+	void* (*draw)(unsigned short seed[3], int total_rows, int* columns);
+	/// Adapts the initial plate to the setting on every MPI process, may be NULL.
+	void (*paint)(const void* setting, double* plate, int total_rows, int columns);
+	/**
+	 * @brief Runs one iteration of the reference implementation of the kernel on the entire plate.
+	 * @param[in] plate The initial plate, which tells the fixed cells.
+	 * @param[in] setting The setting of the trial, NULL if the candidate draws none.
+	 * @param[in] iteration The iteration, counted from 0.
+	 **/
+	double (*golden)(const double* plate, const double* temperatures_last, double* temperatures, int rows, int columns, const void* setting, int iteration);
+	/**
+	 * @brief Builds whatever the kernel needs before iterating, may be NULL.
+	 * @param[in] temperatures_last The initial temperatures of the slab, ghost rows included.
+	 * @param[in] rows The number of rows in the slab.
+	 * @param[in] columns The number of columns.
+	 * @param[in] first_global_row The index of the first row of the slab in the plate.
+	 * @param[in] total_rows The number of rows in the plate.
+	 * @param[in] setting The setting of the trial, NULL if the candidate draws none.
+	 * @return The context passed to propagate.
+	 **/
+	void* (*prepare)(const double* temperatures_last, int rows, int columns, int first_global_row, int total_rows, const void* setting);
+	/**
+	 * @brief Brings the slab to an iteration and fills its ghost rows, may be NULL for the usual exchange with the MPI processes above and below.
+	 * @param[in,out] temperatures_last The temperatures at the previous iteration, ghost rows included.
+	 * @param[in,out] temperatures The other buffer.
+	 * @param[in] iteration The iteration about to run, counted from 0.
+	 **/
+	void (*exchange)(double* temperatures_last, double* temperatures, int rows, int columns, int iteration, void* context);
+	/// Runs one iteration, with the same semantics as heat_propagate.
+	double (*propagate)(const double* temperatures_last, double* temperatures, int rows, int columns, void* context);
+	/// Releases the context returned by prepare, may be NULL.
+	void (*release)(void* context);
+};
+
+/**
+ * @brief Exchanges the ghost rows of a slab with the MPI processes above and below.
+ **/
+static void exchange_ghost_rows(double* temperatures_last, int rows, int columns, int up_neighbour_rank, int down_neighbour_rank)
+{
+	MPI_Sendrecv(&temperatures_last[1 * columns], columns, MPI_DOUBLE, up_neighbour_rank, 0,
+				 &temperatures_last[(rows + 1) * columns], columns, MPI_DOUBLE, down_neighbour_rank, 0, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+	MPI_Sendrecv(&temperatures_last[rows * columns], columns, MPI_DOUBLE, down_neighbour_rank, 1,
+				 &temperatures_last[0], columns, MPI_DOUBLE, up_neighbour_rank, 1, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+}
+
+static double propagate_heat(const double* temperatures_last, double* temperatures, int rows, int columns, void* context)
+{
+	(void)context;
+	return heat_propagate(temperatures_last, temperatures, rows, columns);
+}
+
+/**
+ * @brief Processes the rows that need no ghost row first, then the first and last rows, like the FORTRAN version does to overlap the ghost exchange.
+ **/
+static double propagate_split(const double* temperatures_last, double* temperatures, int rows, int columns, int summation)
+{
+	double temperature_change = 0.0;
+	if(rows > 2)
+	{
+		temperature_change = heat_propagate_strips(temperatures_last, temperatures, 2, rows - 1, columns, summation);
+	}
+	temperature_change = fmax(heat_propagate_strips(temperatures_last, temperatures, 1, 1, columns, summation), temperature_change);
+	if(rows > 1)
+	{
+		temperature_change = fmax(heat_propagate_strips(temperatures_last, temperatures, rows, rows, columns, summation), temperature_change);
+	}
+	return temperature_change;
+}
+
+static double propagate_strips_first(const double* temperatures_last, double* temperatures, int rows, int columns, void* context)
+{
+	(void)context;
+	return propagate_split(temperatures_last, temperatures, rows, columns, HEAT_STRIPS_FIRST);
+}
+
+static double propagate_cells_first(const double* temperatures_last, double* temperatures, int rows, int columns, void* context)
+{
+	(void)context;
+	return propagate_split(temperatures_last, temperatures, rows, columns, HEAT_CELLS_FIRST);
+}
+
+/// The relaxation factor with which sor_sweep and chebyshev_sweep are checked.
+#define CHECK_OMEGA 1.5
+
+/**
+ * @brief What sor_sweep needs besides the temperatures.
+ **/
+struct sor_context
+{
+	/// The fixed cells of the slab, built from the initial temperatures.
+	unsigned char* fixed;
+	/// The index of the first row of the slab in the plate.
+	int first_global_row;
+	/// The ranks of the neighbouring MPI processes, for the ghost row exchange between the two colours.
+	int up_neighbour_rank;
+	int down_neighbour_rank;
+};
+
+static void* prepare_sor(const double* temperatures_last, int rows, int columns, int first_global_row, int total_rows, const void* setting)
+{
+	(void)total_rows;
+	(void)setting;
+	struct sor_context* context = malloc(sizeof(struct sor_context));
+	context->fixed = malloc((size_t)rows * columns);
+	for(int i = 0; i < rows * columns; i++)
+	{
+		context->fixed[i] = temperatures_last[columns + i] == MAX_TEMPERATURE;
+	}
+	int my_rank;
+	int comm_size;
+	MPI_Comm_rank(MPI_COMM_WORLD, &my_rank);
+	MPI_Comm_size(MPI_COMM_WORLD, &comm_size);
+	context->first_global_row = first_global_row;
+	context->up_neighbour_rank = (my_rank == 0) ? MPI_PROC_NULL : my_rank - 1;
+	context->down_neighbour_rank = (my_rank == comm_size - 1) ? MPI_PROC_NULL : my_rank + 1;
+	return context;
+}
+
+static double propagate_sor(const double* temperatures_last, double* temperatures, int rows, int columns, void* context)
+{
+	struct sor_context* sor = context;
+	// The sweeps work in place; the copy keeps the semantics of the other candidates, whose result lands in the other buffer
+	memcpy(temperatures, temperatures_last, (size_t)(rows + 2) * columns * sizeof(double));
+	double temperature_change = sor_sweep(temperatures, sor->fixed, rows, columns, sor->first_global_row, SOR_RED, CHECK_OMEGA);
+	exchange_ghost_rows(temperatures, rows, columns, sor->up_neighbour_rank, sor->down_neighbour_rank);
+	return fmax(sor_sweep(temperatures, sor->fixed, rows, columns, sor->first_global_row, SOR_BLACK, CHECK_OMEGA), temperature_change);
+}
+
+static void release_sor(void* context)
+{
+	struct sor_context* sor = context;
+	free(sor->fixed);
+	free(sor);
+}
+
+static double golden_strips_first(const double* plate, const double* temperatures_last, double* temperatures, int rows, int columns, const void* setting, int iteration)
+{
+	(void)plate;
+	(void)setting;
+	(void)iteration;
+	return golden_propagate(temperatures_last, temperatures, rows, columns, HEAT_STRIPS_FIRST);
+}
+
+static double golden_cells_first(const double* plate, const double* temperatures_last, double* temperatures, int rows, int columns, const void* setting, int iteration)
+{
+	(void)plate;
+	(void)setting;
+	(void)iteration;
+	return golden_propagate(temperatures_last, temperatures, rows, columns, HEAT_CELLS_FIRST);
+}
+
+/**
+ * @brief Builds the fixed cells of a slab from its initial temperatures, for chebyshev_sweep.
+ **/
+static void* prepare_chebyshev(const double* temperatures_last, int rows, int columns, int first_global_row, int total_rows, const void* setting)
+{
+	(void)first_global_row;
+	(void)total_rows;
+	(void)setting;
+	unsigned char* fixed = malloc((size_t)rows * columns);
+	for(int i = 0; i < rows * columns; i++)
+	{
+		fixed[i] = temperatures_last[columns + i] == MAX_TEMPERATURE;
+	}
+	return fixed;
+}
+
+static double propagate_chebyshev(const double* temperatures_last, double* temperatures, int rows, int columns, void* context)
+{
+	return chebyshev_sweep(temperatures_last, temperatures, context, rows, columns, CHECK_OMEGA);
+}
+
+static double golden_red_black(const double* plate, const double* temperatures_last, double* temperatures, int rows, int columns, const void* setting, int iteration)
+{
+	(void)setting;
+	(void)iteration;
+	return golden_sor(plate, temperatures_last, temperatures, rows, columns, CHECK_OMEGA);
+}
+
+static double golden_extrapolated(const double* plate, const double* temperatures_last, double* temperatures, int rows, int columns, const void* setting, int iteration)
+{
+	(void)setting;
+	(void)iteration;
+	return golden_chebyshev(plate, temperatures_last, temperatures, rows, columns, CHECK_OMEGA);
+}
+
+/// The number of members of the ensemble with which ensemble_propagate is checked.
+#define CHECK_MEMBERS 3
+
+/**
+ * @brief The interleaved buffers of the ensemble with which ensemble_propagate is checked.
+ **/
+struct ensemble_context
+{
+	/// The temperatures of every member at the previous iteration, ghost rows included.
+	double* temperatures_last;
+	/// The temperatures of every member at this iteration.
+	double* temperatures;
+	/// The changes every OpenMP thread keeps of its own rows.
+	double* thread_changes;
+};
+
+static void* prepare_ensemble(const double* temperatures_last, int rows, int columns, int first_global_row, int total_rows, const void* setting)
+{
+	(void)temperatures_last;
+	(void)first_global_row;
+	(void)total_rows;
+	(void)setting;
+	struct ensemble_context* context = malloc(sizeof(struct ensemble_context));
+	context->temperatures_last = malloc((size_t)(rows + 2) * columns * CHECK_MEMBERS * sizeof(double));
+	context->temperatures = malloc((size_t)(rows + 2) * columns * CHECK_MEMBERS * sizeof(double));
+	context->thread_changes = malloc((size_t)omp_get_max_threads() * CHECK_MEMBERS * sizeof(double));
+	return context;
+}
+
+/**
+ * @brief Runs the slab in every member of an ensemble; every member must agree with the others, or the change returned is NaN.
+ **/
+static double propagate_ensemble(const double* temperatures_last, double* temperatures, int rows, int columns, void* context)
+{
+	struct ensemble_context* ensemble = context;
+	for(size_t cell = 0; cell < (size_t)(rows + 2) * columns; cell++)
+	{
+		for(int m = 0; m < CHECK_MEMBERS; m++)
+		{
+			ensemble->temperatures_last[cell * CHECK_MEMBERS + m] = temperatures_last[cell];
+		}
+	}
+	double changes[CHECK_MEMBERS];
+	double temperature_change = ensemble_propagate(ensemble->temperatures_last, ensemble->temperatures, rows, columns, CHECK_MEMBERS, changes, ensemble->thread_changes);
+	for(size_t cell = columns; cell < (size_t)(rows + 1) * columns; cell++)
+	{
+		temperatures[cell] = ensemble->temperatures[cell * CHECK_MEMBERS];
+		for(int m = 1; m < CHECK_MEMBERS; m++)
+		{
+			if(memcmp(&ensemble->temperatures[cell * CHECK_MEMBERS + m], &temperatures[cell], sizeof(double)) != 0)
+			{
+				temperature_change = NAN;
+			}
+		}
+	}
+	for(int m = 0; m < CHECK_MEMBERS; m++)
+	{
+		if(changes[m] != changes[0])
+		{
+			temperature_change = NAN;
+		}
+	}
+	return temperature_change;
+}
+
+static void release_ensemble(void* context)
+{
+	struct ensemble_context* ensemble = context;
+	free(ensemble->temperatures_last);
+	free(ensemble->temperatures);
+	free(ensemble->thread_changes);
+	free(ensemble);
+}
+
+/// The most sources in a random layout.
+#define CHECK_SOURCES 12
+
+/**
+ * @brief A random layout of sources with which sources_propagate is checked.
+ **/
+struct sources_setting
+{
+	/// The sources, whose list is the array below.
+	struct sources sources;
+	struct source list[CHECK_SOURCES];
+};
+
+/**
+ * @brief Draws a random integer in [low, high] from a seed of its own.
+ **/
+static int seeded_between(unsigned short seed[3], int low, int high)
+{
+	return low + (int)(erand48(seed) * (high - low + 1));
+}
+
+/**
+ * @brief Draws a layout of sources of every shape and of several temperatures, some of them overlapping, some of them beyond the edges of the plate.
+ **/
+static void* draw_sources(unsigned short seed[3], int total_rows, int* columns)
+{
+	struct sources_setting* setting = malloc(sizeof(struct sources_setting));
+	setting->sources.list = setting->list;
+	setting->sources.count = seeded_between(seed, 1, CHECK_SOURCES);
+	for(int s = 0; s < setting->sources.count; s++)
+	{
+		struct source* source = &setting->list[s];
+		memset(source, 0, sizeof(struct source));
+		source->shape = (enum source_shape)seeded_between(seed, SOURCE_RECTANGLE, SOURCE_POINT);
+		// Few temperatures, so that neighbouring sources sometimes share theirs and their spans merge
+		source->temperature = MAX_TEMPERATURE * seeded_between(seed, 1, 4) / 4.0;
+		source->row0 = seeded_between(seed, -4, total_rows + 3);
+		source->column0 = seeded_between(seed, -4, *columns + 3);
+		source->row1 = source->row0 + seeded_between(seed, -12, 12);
+		source->column1 = source->column0 + seeded_between(seed, -12, 12);
+		source->radius = seeded_between(seed, 0, 8);
+		source->until = INT_MAX;
+	}
+	return setting;
+}
+
+/**
+ * @brief Places sources on the entire plate as they are at an iteration, shape by shape and cell by cell, without the spans.
+ * @param[out] fixed The cells of the sources, total_rows * columns.
+ * @param[out] values The temperatures of the cells of the sources, same layout; the other cells are not written.
+ **/
+static void place_sources(const struct sources* sources, int iteration, unsigned char* fixed, double* values, int total_rows, int columns)
+{
+	memset(fixed, 0, (size_t)total_rows * columns);
+	for(int s = 0; s < sources->count; s++)
+	{
+		const struct source* source = &sources->list[s];
+		if(iteration < source->from || iteration >= source->until)
+		{
+			continue;
+		}
+		const int moves = (source->move_every > 0) ? (iteration - source->from) / source->move_every : 0;
+		const int row0 = source->row0 + moves * source->move_rows;
+		const int row1 = source->row1 + moves * source->move_rows;
+		const int column0 = source->column0 + moves * source->move_columns;
+		const int column1 = source->column1 + moves * source->move_columns;
+		if(source->shape == SOURCE_LINE)
+		{
+			// A line has one cell per step along its longer axis, rounded to the nearest
+			const int steps = (abs(row1 - row0) > abs(column1 - column0)) ? abs(row1 - row0) : abs(column1 - column0);
+			for(int k = 0; k <= steps; k++)
+			{
+				const int i = row0 + (steps ? (int)lround((double)k * (row1 - row0) / steps) : 0);
+				const int j = column0 + (steps ? (int)lround((double)k * (column1 - column0) / steps) : 0);
+				if(i >= 0 && i < total_rows && j >= 0 && j < columns)
+				{
+					fixed[i * columns + j] = 1;
+					values[i * columns + j] = source->temperature;
+				}
+			}
+			continue;
+		}
+		for(int i = 0; i < total_rows; i++)
+		{
+			for(int j = 0; j < columns; j++)
+			{
+				int inside = 0;
+				switch(source->shape)
+				{
+					case SOURCE_RECTANGLE:
+						inside = (i - row0) * (i - row1) <= 0 && (j - column0) * (j - column1) <= 0;
+						break;
+					case SOURCE_DISC:
+						inside = (i - row0) * (i - row0) + (j - column0) * (j - column0) <= source->radius * source->radius;
+						break;
+					case SOURCE_LINE:
+						break;
+					case SOURCE_POINT:
+						inside = i == row0 && j == column0;
+						break;
+				}
+				if(inside)
+				{
+					fixed[i * columns + j] = 1;
+					values[i * columns + j] = source->temperature;
+				}
+			}
+		}
+	}
+}
+
+/**
+ * @brief Brings the cells of the sources to their temperature, as the program does before the first iteration.
+ **/
+static void paint_sources(const void* setting, double* plate, int total_rows, int columns)
+{
+	const struct sources_setting* sources = setting;
+	unsigned char* fixed = malloc((size_t)total_rows * columns);
+	double* values = malloc((size_t)total_rows * columns * sizeof(double));
+	place_sources(&sources->sources, 0, fixed, values, total_rows, columns);
+	for(int i = 0; i < total_rows * columns; i++)
+	{
+		plate[i] = fixed[i] ? values[i] : plate[i];
+	}
+	free(fixed);
+	free(values);
+}
+
+static double golden_sources(const double* plate, const double* temperatures_last, double* temperatures, int rows, int columns, const void* setting, int iteration)
+{
+	(void)plate;
+	const struct sources_setting* sources = setting;
+	unsigned char* fixed = malloc((size_t)rows * columns);
+	double* values = malloc((size_t)rows * columns * sizeof(double));
+	place_sources(&sources->sources, iteration, fixed, values, rows, columns);
+	double temperature_change = golden_fixed(fixed, values, temperatures_last, temperatures, rows, columns);
+	free(fixed);
+	free(values);
+	return temperature_change;
+}
+
+/**
+ * @brief Compiles the sources of the setting into the spans of the slab, for sources_propagate.
+ **/
+static void* prepare_sources(const double* temperatures_last, int rows, int columns, int first_global_row, int total_rows, const void* setting)
+{
+	(void)temperatures_last;
+	(void)total_rows;
+	const struct sources_setting* sources = setting;
+	struct source_spans* spans = malloc(sizeof(struct source_spans));
+	sources_compile(&sources->sources, spans, first_global_row, rows, columns, 0);
+	return spans;
+}
+
+static double propagate_sources(const double* temperatures_last, double* temperatures, int rows, int columns, void* context)
+{
+	return sources_propagate(temperatures_last, temperatures, rows, columns, context);
+}
+
+static void release_sources(void* context)
+{
+	sources_spans_free(context);
+	free(context);
+}
+
+/**
+ * @brief Draws a layout of sources like draw_sources, every one of which switches on, switches off and moves at random iterations.
+ **/
+static void* draw_schedule(unsigned short seed[3], int total_rows, int* columns)
+{
+	struct sources_setting* setting = draw_sources(seed, total_rows, columns);
+	for(int s = 0; s < setting->sources.count; s++)
+	{
+		struct source* source = &setting->list[s];
+		source->from = seeded_between(seed, 0, 1) ? 0 : seeded_between(seed, 1, 30);
+		source->until = seeded_between(seed, 0, 1) ? INT_MAX : source->from + seeded_between(seed, 1, 40);
+		source->move_every = seeded_between(seed, 0, 6);
+		source->move_rows = seeded_between(seed, -3, 3);
+		source->move_columns = seeded_between(seed, -3, 3);
+	}
+	return setting;
+}
+
+/**
+ * @brief What the incremental updates of sources_update need besides the temperatures.
+ **/
+struct schedule_context
+{
+	/// The sources of the setting.
+	const struct sources* sources;
+	/// The spans of the slab, brought from one iteration to the next by sources_update.
+	struct source_spans spans;
+	/// The fixed cells of the slab, likewise.
+	unsigned char* fixed;
+	/// The fixed cells of the spans compiled from scratch, to compare with.
+	unsigned char* compiled_fixed;
+	/// The ranks of the neighbouring MPI processes.
+	int up_neighbour_rank;
+	int down_neighbour_rank;
+	/// 0 once the updated spans or fixed cells differed from those compiled from scratch.
+	int consistent;
+};
+
+static void* prepare_schedule(const double* temperatures_last, int rows, int columns, int first_global_row, int total_rows, const void* setting)
+{
+	(void)temperatures_last;
+	(void)total_rows;
+	const struct sources_setting* sources = setting;
+	struct schedule_context* context = malloc(sizeof(struct schedule_context));
+	context->sources = &sources->sources;
+	sources_compile(context->sources, &context->spans, first_global_row, rows, columns, 0);
+	context->fixed = malloc((size_t)rows * columns);
+	context->compiled_fixed = malloc((size_t)rows * columns);
+	sources_mark(&context->spans, context->fixed, columns);
+	int my_rank;
+	int comm_size;
+	MPI_Comm_rank(MPI_COMM_WORLD, &my_rank);
+	MPI_Comm_size(MPI_COMM_WORLD, &comm_size);
+	context->up_neighbour_rank = (my_rank == 0) ? MPI_PROC_NULL : my_rank - 1;
+	context->down_neighbour_rank = (my_rank == comm_size - 1) ? MPI_PROC_NULL : my_rank + 1;
+	context->consistent = 1;
+	return context;
+}
+
+/**
+ * @brief Updates the spans, fixed cells and temperatures of the slab incrementally, as the program does before every iteration, and compares the spans and fixed cells with those compiled from scratch.
+ **/
+static void exchange_schedule(double* temperatures_last, double* temperatures, int rows, int columns, int iteration, void* context)
+{
+	struct schedule_context* schedule = context;
+	sources_update(schedule->sources, &schedule->spans, iteration, &temperatures_last[columns], &temperatures[columns], schedule->fixed);
+	struct source_spans compiled;
+	sources_compile(schedule->sources, &compiled, schedule->spans.first_row, rows, columns, iteration);
+	sources_mark(&compiled, schedule->compiled_fixed, columns);
+	if(compiled.next_change != schedule->spans.next_change || memcmp(compiled.row_counts, schedule->spans.row_counts, rows * sizeof(int)) != 0 || memcmp(schedule->fixed, schedule->compiled_fixed, (size_t)rows * columns) != 0)
+	{
+		schedule->consistent = 0;
+	}
+	for(int i = 0; i < rows && schedule->consistent; i++)
+	{
+		const struct source_span* updated_spans = &schedule->spans.spans[schedule->spans.row_offsets[i]];
+		const struct source_span* compiled_spans = &compiled.spans[compiled.row_offsets[i]];
+		for(int s = 0; s < compiled.row_counts[i]; s++)
+		{
+			if(updated_spans[s].begin != compiled_spans[s].begin || updated_spans[s].end != compiled_spans[s].end || updated_spans[s].temperature != compiled_spans[s].temperature)
+			{
+				schedule->consistent = 0;
+			}
+		}
+	}
+	sources_spans_free(&compiled);
+	exchange_ghost_rows(temperatures_last, rows, columns, schedule->up_neighbour_rank, schedule->down_neighbour_rank);
+}
+
+/**
+ * @brief Runs sources_propagate on the updated spans; the change returned is NaN once the updates went wrong.
+ **/
+static double propagate_schedule(const double* temperatures_last, double* temperatures, int rows, int columns, void* context)
+{
+	struct schedule_context* schedule = context;
+	double temperature_change = sources_propagate(temperatures_last, temperatures, rows, columns, &schedule->spans);
+	return schedule->consistent ? temperature_change : NAN;
+}
+
+static void release_schedule(void* context)
+{
+	struct schedule_context* schedule = context;
+	sources_spans_free(&schedule->spans);
+	free(schedule->fixed);
+	free(schedule->compiled_fixed);
+	free(schedule);
+}
+
+/**
+ * @brief Draws the conductivity of every cell of the plate, all positive and spread over two orders of magnitude so that no two faces look alike.
+ **/
+static void* draw_conductivity(unsigned short seed[3], int total_rows, int* columns)
+{
+	double* map = malloc((size_t)total_rows * *columns * sizeof(double));
+	for(int i = 0; i < total_rows * *columns; i++)
+	{
+		map[i] = 0.1 + 10.0 * erand48(seed);
+	}
+	return map;
+}
+
+static double golden_materials(const double* plate, const double* temperatures_last, double* temperatures, int rows, int columns, const void* setting, int iteration)
+{
+	(void)iteration;
+	return golden_conductivity(plate, setting, temperatures_last, temperatures, rows, columns);
+}
+
+/**
+ * @brief What conductivity_propagate needs besides the temperatures.
+ **/
+struct conductivity_context
+{
+	/// The coefficients of the slab, built from the map of the setting.
+	struct conductivity conductivity;
+	/// The fixed cells of the slab, built from the initial temperatures.
+	unsigned char* fixed;
+};
+
+/**
+ * @brief Builds the coefficients of the slab like conductivity_create does: from the map of its own rows, and of the rows around it taken from its neighbours.
+ **/
+static void* prepare_conductivity(const double* temperatures_last, int rows, int columns, int first_global_row, int total_rows, const void* setting)
+{
+	struct conductivity_context* context = malloc(sizeof(struct conductivity_context));
+	struct slab slab;
+	slab_create_rows(&slab, MPI_COMM_WORLD, rows, columns);
+	double* map = malloc((size_t)(rows + 2) * columns * sizeof(double));
+	// The ghost rows at the edges of the plate must not be read, a NaN there would spread to every result
+	for(int j = 0; j < columns; j++)
+	{
+		map[j] = NAN;
+		map[(size_t)(rows + 1) * columns + j] = NAN;
+	}
+	memcpy(&map[columns], &((const double*)setting)[(size_t)first_global_row * columns], (size_t)rows * columns * sizeof(double));
+	slab_exchange_ghost_rows(&slab, map);
+	conductivity_build(&context->conductivity, map, rows, columns, first_global_row, total_rows);
+	free(map);
+	slab_destroy(&slab);
+	context->fixed = malloc((size_t)rows * columns);
+	for(int i = 0; i < rows * columns; i++)
+	{
+		context->fixed[i] = temperatures_last[columns + i] == MAX_TEMPERATURE;
+	}
+	return context;
+}
+
+static double propagate_conductivity(const double* temperatures_last, double* temperatures, int rows, int columns, void* context)
+{
+	struct conductivity_context* conductivity = context;
+	return conductivity_propagate(temperatures_last, temperatures, conductivity->fixed, rows, columns, &conductivity->conductivity);
+}
+
+static void release_conductivity(void* context)
+{
+	struct conductivity_context* conductivity = context;
+	conductivity_destroy(&conductivity->conductivity);
+	free(conductivity->fixed);
+	free(conductivity);
+}
+
+/**
+ * @brief The shape of the block with which heat3d_propagate is checked, whose planes are the rows of the plate.
+ **/
+struct block_setting
+{
+	/// The rows and columns of a plane, whose product is the number of columns of the plate.
+	int rows;
+	int columns;
+	/// The tiles of a plane, small to cross many of them.
+	int tile_rows;
+	int tile_columns;
+};
+
+/**
+ * @brief Makes every row of the plate a plane of a few rows, adjusting the number of columns to a multiple of them, and draws tiles of any size.
+ **/
+static void* draw_block(unsigned short seed[3], int total_rows, int* columns)
+{
+	(void)total_rows;
+	struct block_setting* block = malloc(sizeof(struct block_setting));
+	block->rows = seeded_between(seed, 1, 8);
+	block->columns = (*columns / block->rows > 2) ? *columns / block->rows : 2;
+	block->tile_rows = seeded_between(seed, 1, block->rows);
+	block->tile_columns = seeded_between(seed, 1, block->columns);
+	*columns = block->rows * block->columns;
+	return block;
+}
+
+static double golden_block(const double* plate, const double* temperatures_last, double* temperatures, int rows, int columns, const void* setting, int iteration)
+{
+	(void)plate;
+	(void)columns;
+	(void)iteration;
+	const struct block_setting* block = setting;
+	return golden_heat3d(temperatures_last, temperatures, rows, block->rows, block->columns);
+}
+
+static void* prepare_heat3d(const double* temperatures_last, int rows, int columns, int first_global_row, int total_rows, const void* setting)
+{
+	(void)temperatures_last;
+	(void)rows;
+	(void)columns;
+	(void)first_global_row;
+	(void)total_rows;
+	struct block_setting* block = malloc(sizeof(struct block_setting));
+	*block = *(const struct block_setting*)setting;
+	return block;
+}
+
+/**
+ * @brief Runs the slab as a slab of planes, each row of the slab being a plane of the block.
+ **/
+static double propagate_heat3d(const double* temperatures_last, double* temperatures, int rows, int columns, void* context)
+{
+	(void)columns;
+	const struct block_setting* block = context;
+	return heat3d_propagate(temperatures_last, temperatures, rows, block->rows, block->columns, block->tile_rows, block->tile_columns);
+}
+
+/**
+ * @brief Draws the conditions of every edge: periodic in pairs, fixed at a random value or insulated otherwise.
+ **/
+static void* draw_boundary(unsigned short seed[3], int total_rows, int* columns)
+{
+	(void)total_rows;
+	(void)columns;
+	struct boundary* boundary = malloc(sizeof(struct boundary));
+	for(int edge = 0; edge < BOUNDARY_EDGES; edge += 2)
+	{
+		const int periodic = seeded_between(seed, 0, 2) == 0;
+		for(int side = edge; side < edge + 2; side++)
+		{
+			boundary->modes[side] = periodic ? BOUNDARY_PERIODIC : (enum boundary_mode)seeded_between(seed, BOUNDARY_FIXED, BOUNDARY_INSULATED);
+			boundary->values[side] = MAX_TEMPERATURE * erand48(seed);
+		}
+	}
+	return boundary;
+}
+
+static double golden_edges(const double* plate, const double* temperatures_last, double* temperatures, int rows, int columns, const void* setting, int iteration)
+{
+	(void)plate;
+	(void)iteration;
+	return golden_boundary(setting, temperatures_last, temperatures, rows, columns);
+}
+
+/**
+ * @brief What boundary_propagate needs besides the temperatures.
+ **/
+struct boundary_context
+{
+	/// The conditions of the setting.
+	struct boundary boundary;
+	/// The slab of this MPI process in the decomposition of the trial, linked into a ring if the top and bottom are periodic.
+	struct slab slab;
+};
+
+static void* prepare_boundary(const double* temperatures_last, int rows, int columns, int first_global_row, int total_rows, const void* setting)
+{
+	(void)temperatures_last;
+	(void)first_global_row;
+	(void)total_rows;
+	struct boundary_context* context = malloc(sizeof(struct boundary_context));
+	context->boundary = *(const struct boundary*)setting;
+	slab_create_rows(&context->slab, MPI_COMM_WORLD, rows, columns);
+	boundary_link(&context->boundary, &context->slab);
+	return context;
+}
+
+/**
+ * @brief Fills the ghost rows as the program does with these conditions: the exchange, around the ring if periodic, then the rows at the edges of the plate.
+ **/
+static void exchange_boundary(double* temperatures_last, double* temperatures, int rows, int columns, int iteration, void* context)
+{
+	(void)temperatures;
+	(void)rows;
+	(void)columns;
+	(void)iteration;
+	struct boundary_context* edges = context;
+	slab_exchange_ghost_rows(&edges->slab, temperatures_last);
+	boundary_fill_ghost_rows(&edges->boundary, &edges->slab, temperatures_last);
+}
+
+static double propagate_boundary(const double* temperatures_last, double* temperatures, int rows, int columns, void* context)
+{
+	struct boundary_context* edges = context;
+	return boundary_propagate(temperatures_last, temperatures, rows, columns, &edges->boundary);
+}
+
+static void release_boundary(void* context)
+{
+	struct boundary_context* edges = context;
+	slab_destroy(&edges->slab);
+	free(edges);
+}
+
+/**
+ * @brief Draws the metal of the plate: cells cut out at random, which leaves cells with few neighbours of metal or none, and rectangles cut out across many rows, which cross the boundaries between slabs.
+ **/
+static void* draw_metal(unsigned short seed[3], int total_rows, int* columns)
+{
+	unsigned char* metal = malloc((size_t)total_rows * *columns);
+	const double hole_fraction = 0.5 * erand48(seed);
+	for(int i = 0; i < total_rows * *columns; i++)
+	{
+		metal[i] = erand48(seed) >= hole_fraction;
+	}
+	const int cut_outs = seeded_between(seed, 0, 4);
+	for(int c = 0; c < cut_outs; c++)
+	{
+		const int top = seeded_between(seed, 0, total_rows - 1);
+		const int bottom = seeded_between(seed, top, (top + 20 < total_rows - 1) ? top + 20 : total_rows - 1);
+		const int left = seeded_between(seed, 0, *columns - 1);
+		const int right = seeded_between(seed, left, *columns - 1);
+		for(int i = top; i <= bottom; i++)
+		{
+			memset(&metal[(size_t)i * *columns + left], 0, right - left + 1);
+		}
+	}
+	return metal;
+}
+
+static double golden_metal(const double* plate, const double* temperatures_last, double* temperatures, int rows, int columns, const void* setting, int iteration)
+{
+	(void)plate;
+	(void)iteration;
+	return golden_geometry(setting, temperatures_last, temperatures, rows, columns);
+}
+
+/**
+ * @brief Compiles the metal of the slab and of the rows around it, like geometry_create does; the ghost rows at the edges of the plate are metal.
+ **/
+static void* prepare_geometry(const double* temperatures_last, int rows, int columns, int first_global_row, int total_rows, const void* setting)
+{
+	(void)temperatures_last;
+	const unsigned char* plate_metal = setting;
+	struct geometry* geometry = malloc(sizeof(struct geometry));
+	unsigned char* metal = malloc((size_t)(rows + 2) * columns);
+	for(int i = 0; i < rows + 2; i++)
+	{
+		const int global_row = first_global_row + i - 1;
+		if(global_row < 0 || global_row >= total_rows)
+		{
+			memset(&metal[(size_t)i * columns], 1, columns);
+		}
+		else
+		{
+			memcpy(&metal[(size_t)i * columns], &plate_metal[(size_t)global_row * columns], columns);
+		}
+	}
+	geometry_build(geometry, metal, rows, columns);
+	free(metal);
+	return geometry;
+}
+
+static double propagate_geometry(const double* temperatures_last, double* temperatures, int rows, int columns, void* context)
+{
+	return geometry_propagate(temperatures_last, temperatures, rows, columns, context);
+}
+
+static void release_geometry(void* context)
+{
+	geometry_destroy(context);
+	free(context);
+}
+
+/// The kernels checked.
+static const struct candidate candidates[] =
+{
+	{"heat_propagate", NULL, NULL, golden_strips_first, NULL, NULL, propagate_heat, NULL},
+	{"heat_propagate_strips (C order)", NULL, NULL, golden_strips_first, NULL, NULL, propagate_strips_first, NULL},
+	{"heat_propagate_strips (FORTRAN order)", NULL, NULL, golden_cells_first, NULL, NULL, propagate_cells_first, NULL},
+	{"sor_sweep", NULL, NULL, golden_red_black, prepare_sor, NULL, propagate_sor, release_sor},
+	{"chebyshev_sweep", NULL, NULL, golden_extrapolated, prepare_chebyshev, NULL, propagate_chebyshev, free},
+	{"ensemble_propagate", NULL, NULL, golden_strips_first, prepare_ensemble, NULL, propagate_ensemble, release_ensemble},
+	{"sources_propagate", draw_sources, paint_sources, golden_sources, prepare_sources, NULL, propagate_sources, release_sources},
+	{"sources_update", draw_schedule, paint_sources, golden_sources, prepare_schedule, exchange_schedule, propagate_schedule, release_schedule},
+	{"conductivity_propagate", draw_conductivity, NULL, golden_materials, prepare_conductivity, NULL, propagate_conductivity, release_conductivity},
+	{"heat3d_propagate", draw_block, NULL, golden_block, prepare_heat3d, NULL, propagate_heat3d, free},
+	{"boundary_propagate", draw_boundary, NULL, golden_edges, prepare_boundary, exchange_boundary, propagate_boundary, release_boundary},
+	{"geometry_propagate", draw_metal, NULL, golden_metal, prepare_geometry, NULL, propagate_geometry, release_geometry},
+};
+
+/**
+ * @brief Draws a random integer in [low, high].
+ **/
+static int random_between(int low, int high)
+{
+	return low + (int)(drand48() * (high - low + 1));
+}
+
+/**
+ * @brief Builds a random plate on the master MPI process.
+ **/
+static double* random_plate(int rows, int columns)
+{
+	double* plate = malloc((size_t)rows * columns * sizeof(double));
+	double fixed_fraction = drand48() * 0.3;
+	// Half the plates start cold like the real one, the other half with random temperatures everywhere
+	int cold = drand48() < 0.5;
+	for(int i = 0; i < rows * columns; i++)
+	{
+		if(drand48() < fixed_fraction)
+		{
+			plate[i] = MAX_TEMPERATURE;
+		}
+		else
+		{
+			plate[i] = cold ? 0.0 : drand48() * MAX_TEMPERATURE;
+		}
+	}
+	return plate;
+}
+
+/**
+ * @brief Runs one trial of one candidate.
+ * @return The number of mismatches found, on the master MPI process.
+ **/
+static int run_trial(const struct candidate* candidate, int trial, int iterations, int my_rank, int comm_size)
+{
+	const int MASTER_PROCESS_RANK = 0;
+
+	// The master MPI process draws the plate, its decomposition, the number of threads and the seed of the setting, then tells everybody.
+	int dimensions[4];
+	if(my_rank == MASTER_PROCESS_RANK)
+	{
+		dimensions[0] = random_between(comm_size, comm_size + 150);
+		dimensions[1] = random_between(2, 150);
+		dimensions[2] = random_between(1, 4);
+		dimensions[3] = (int)lrand48();
+	}
+	MPI_Bcast(dimensions, 4, MPI_INT, MASTER_PROCESS_RANK, MPI_COMM_WORLD);
+	const int total_rows = dimensions[0];
+	int columns = dimensions[1];
+	omp_set_num_threads(dimensions[2]);
+	unsigned short seed[3] = {(unsigned short)dimensions[3], (unsigned short)(dimensions[3] >> 16), 0x330E};
+	void* setting = candidate->draw ? candidate->draw(seed, total_rows, &columns) : NULL;
+
+	double* plate = NULL;
+	int row_counts[comm_size];
+	if(my_rank == MASTER_PROCESS_RANK)
+	{
+		plate = random_plate(total_rows, columns);
+		// Every MPI process gets at least one row, the rest are spread randomly
+		int remaining = total_rows - comm_size;
+		for(int i = 0; i < comm_size; i++)
+		{
+			int extra = (i == comm_size - 1) ? remaining : random_between(0, remaining);
+			row_counts[i] = 1 + extra;
+			remaining -= extra;
+		}
+	}
+	else
+	{
+		plate = malloc((size_t)total_rows * columns * sizeof(double));
+	}
+	MPI_Bcast(row_counts, comm_size, MPI_INT, MASTER_PROCESS_RANK, MPI_COMM_WORLD);
+	MPI_Bcast(plate, total_rows * columns, MPI_DOUBLE, MASTER_PROCESS_RANK, MPI_COMM_WORLD);
+	if(candidate->paint)
+	{
+		candidate->paint(setting, plate, total_rows, columns);
+	}
+
+	int first_global_row = 0;
+	for(int i = 0; i < my_rank; i++)
+	{
+		first_global_row += row_counts[i];
+	}
+	const int rows = row_counts[my_rank];
+	const int up_neighbour_rank = (my_rank == 0) ? MPI_PROC_NULL : my_rank - 1;
+	const int down_neighbour_rank = (my_rank == comm_size - 1) ? MPI_PROC_NULL : my_rank + 1;
+
+	double* temperatures_last = calloc((size_t)(rows + 2) * columns, sizeof(double));
+	double* temperatures = calloc((size_t)(rows + 2) * columns, sizeof(double));
+	memcpy(&temperatures_last[columns], &plate[(size_t)first_global_row * columns], (size_t)rows * columns * sizeof(double));
+	memcpy(&temperatures[columns], &temperatures_last[columns], (size_t)rows * columns * sizeof(double));
+
+	exchange_ghost_rows(temperatures_last, rows, columns, up_neighbour_rank, down_neighbour_rank);
+	void* context = candidate->prepare ? candidate->prepare(temperatures_last, rows, columns, first_global_row, total_rows, setting) : NULL;
+
+	double changes[iterations];
+	for(int k = 0; k < iterations; k++)
+	{
+		if(candidate->exchange)
+		{
+			candidate->exchange(temperatures_last, temperatures, rows, columns, k, context);
+		}
+		else
+		{
+			exchange_ghost_rows(temperatures_last, rows, columns, up_neighbour_rank, down_neighbour_rank);
+		}
+		double my_temperature_change = candidate->propagate(temperatures_last, temperatures, rows, columns, context);
+		MPI_Allreduce(&my_temperature_change, &changes[k], 1, MPI_DOUBLE, MPI_MAX, MPI_COMM_WORLD);
+		double* swap = temperatures_last;
+		temperatures_last = temperatures;
+		temperatures = swap;
+	}
+
+	if(candidate->release)
+	{
+		candidate->release(context);
+	}
+
+	// Collect the result on the master MPI process and replay the trial with the reference implementation
+	int displacements[comm_size];
+	int counts[comm_size];
+	for(int i = 0, offset = 0; i < comm_size; i++)
+	{
+		counts[i] = row_counts[i] * columns;
+		displacements[i] = offset;
+		offset += counts[i];
+	}
+	double* result = (my_rank == MASTER_PROCESS_RANK) ? malloc((size_t)total_rows * columns * sizeof(double)) : NULL;
+	MPI_Gatherv(&temperatures_last[columns], rows * columns, MPI_DOUBLE, result, counts, displacements, MPI_DOUBLE, MASTER_PROCESS_RANK, MPI_COMM_WORLD);
+
+	int mismatches = 0;
+	if(my_rank == MASTER_PROCESS_RANK)
+	{
+		// The plate itself is kept intact, it tells the fixed cells; like the slabs, both buffers start as the plate
+		double* reference_last = malloc((size_t)total_rows * columns * sizeof(double));
+		double* reference = malloc((size_t)total_rows * columns * sizeof(double));
+		memcpy(reference_last, plate, (size_t)total_rows * columns * sizeof(double));
+		memcpy(reference, plate, (size_t)total_rows * columns * sizeof(double));
+		for(int k = 0; k < iterations; k++)
+		{
+			double change = candidate->golden(plate, reference_last, reference, total_rows, columns, setting, k);
+			if(memcmp(&change, &changes[k], sizeof(double)) != 0 && mismatches++ == 0)
+			{
+				printf("[FAILURE] %s, trial %d (%dx%d, %d threads): maximum temperature change of iteration %d is %.18f instead of %.18f.\n",
+					   candidate->name, trial, total_rows, columns, dimensions[2], k, changes[k], change);
+			}
+			double* swap = reference_last;
+			reference_last = reference;
+			reference = swap;
+		}
+		for(int i = 0; i < total_rows * columns; i++)
+		{
+			if(memcmp(&result[i], &reference_last[i], sizeof(double)) != 0 && mismatches++ == 0)
+			{
+				printf("[FAILURE] %s, trial %d (%dx%d, %d threads): cell at row %d column %d is %.18f instead of %.18f after %d iterations.\n",
+					   candidate->name, trial, total_rows, columns, dimensions[2], i / columns, i % columns, result[i], reference_last[i], iterations);
+			}
+		}
+		free(reference_last);
+		free(reference);
+		free(result);
+	}
+
+	free(setting);
+	free(plate);
+	free(temperatures_last);
+	free(temperatures);
+	return mismatches;
+}
+
+int main(int argc, char* argv[])
+{
+	MPI_Init(NULL, NULL);
+
+	int my_rank;
+	MPI_Comm_rank(MPI_COMM_WORLD, &my_rank);
+	int comm_size;
+	MPI_Comm_size(MPI_COMM_WORLD, &comm_size);
+
+	int trials = 20;
+	int iterations = 50;
+	long seed = 1;
+	for(int i = 1; i + 1 < argc; i += 2)
+	{
+		if(strcmp(argv[i], "--trials") == 0)
+		{
+			trials = atoi(argv[i + 1]);
+		}
+		else if(strcmp(argv[i], "--iterations") == 0)
+		{
+			iterations = atoi(argv[i + 1]);
+		}
+		else if(strcmp(argv[i], "--seed") == 0)
+		{
+			seed = atol(argv[i + 1]);
+		}
+	}
+	srand48(seed);
+
+	int failures = 0;
+	for(size_t c = 0; c < sizeof(candidates) / sizeof(candidates[0]); c++)
+	{
+		int failed_trials = 0;
+		for(int trial = 0; trial < trials; trial++)
+		{
+			if(run_trial(&candidates[c], trial, iterations, my_rank, comm_size) > 0)
+			{
+				failed_trials++;
+			}
+		}
+		if(my_rank == 0 && failed_trials == 0)
+		{
+			printf("[SUCCESS] %s matches the reference on %d random plates, %d iterations each, across %d MPI processes.\n", candidates[c].name, trials, iterations, comm_size);
+		}
+		failures += failed_trials;
+	}
+
+	MPI_Bcast(&failures, 1, MPI_INT, 0, MPI_COMM_WORLD);
+	MPI_Finalize();
+	return failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
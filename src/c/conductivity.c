@@ -0,0 +1,165 @@
+/**
+ * @file conductivity.c
+ * @brief A plate made of several materials, each with its own conductivity.
+ **/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include "conductivity.h"
+#include "sources.h"
+
+/**
+ * @brief Returns the conductivity of the face between two cells: the harmonic mean of theirs.
+ **/
+static inline double face(double a, double b)
+{
+	return 2.0 * a * b / (a + b);
+}
+
+int conductivity_build(struct conductivity* conductivity, const double* map, int rows, int columns, int first_global_row, int total_rows)
+{
+	const size_t cells = (size_t)rows * columns;
+	conductivity->up = malloc(cells * sizeof(double));
+	conductivity->down = malloc(cells * sizeof(double));
+	conductivity->left = malloc(cells * sizeof(double));
+	conductivity->right = malloc(cells * sizeof(double));
+	conductivity->total = malloc(cells * sizeof(double));
+	if(conductivity->up == NULL || conductivity->down == NULL || conductivity->left == NULL || conductivity->right == NULL || conductivity->total == NULL)
+	{
+		conductivity_destroy(conductivity);
+		return -1;
+	}
+
+	#pragma omp parallel for
+	for(int i = 1; i <= rows; i++)
+	{
+		const int global_row = first_global_row + i - 1;
+		const double* above = &map[(size_t)(i - 1) * columns];
+		const double* cell = &map[(size_t)i * columns];
+		const double* below = &map[(size_t)(i + 1) * columns];
+		const size_t row = (size_t)(i - 1) * columns;
+		for(int j = 0; j < columns; j++)
+		{
+			// Beyond the top and bottom edges lies the ghost row at 0, through a face of the conductivity of the cell
+			conductivity->up[row + j] = (global_row == 0) ? cell[j] : face(cell[j], above[j]);
+			conductivity->down[row + j] = (global_row == total_rows - 1) ? cell[j] : face(cell[j], below[j]);
+			conductivity->left[row + j] = (j == 0) ? 0.0 : face(cell[j], cell[j - 1]);
+			conductivity->right[row + j] = (j == columns - 1) ? 0.0 : face(cell[j], cell[j + 1]);
+			conductivity->total[row + j] = conductivity->up[row + j] + conductivity->down[row + j] + conductivity->left[row + j] + conductivity->right[row + j];
+		}
+	}
+	return 0;
+}
+
+int conductivity_create(struct conductivity* conductivity, const struct slab* slab, const char* path)
+{
+	memset(conductivity, 0, sizeof(*conductivity));
+	struct sources materials;
+	if(sources_load(&materials, path) != 0)
+	{
+		return -1;
+	}
+	int valid = !sources_scheduled(&materials);
+	for(int m = 0; m < materials.count; m++)
+	{
+		valid = valid && materials.list[m].temperature > 0.0;
+	}
+	if(!valid)
+	{
+		if(slab->my_rank == 0)
+		{
+			fprintf(stderr, "The conductivities of \"%s\" must be positive and cannot follow a schedule.\n", path);
+		}
+		sources_free(&materials);
+		return -1;
+	}
+
+	// Every MPI process generates its own rows, then takes those around its slab from its neighbours
+	const int columns = slab->columns;
+	double* map = malloc((size_t)(slab->rows + 2) * columns * sizeof(double));
+	struct source_spans spans = {0};
+	int allocated = map != NULL && sources_compile(&materials, &spans, slab->first_global_row, slab->rows, columns, 0) == 0;
+	if(!allocated)
+	{
+		fprintf(stderr, "Cannot allocate the conductivity map.\n");
+	}
+	// Everybody gives up together rather than leave the others waiting in the exchange
+	MPI_Allreduce(MPI_IN_PLACE, &allocated, 1, MPI_INT, MPI_MIN, slab->comm);
+	if(!allocated)
+	{
+		sources_spans_free(&spans);
+		free(map);
+		sources_free(&materials);
+		return -1;
+	}
+	for(size_t k = 0; k < (size_t)(slab->rows + 2) * columns; k++)
+	{
+		map[k] = 1.0;
+	}
+	sources_paint(&spans, &map[columns], columns);
+	slab_exchange_ghost_rows(slab, map);
+	const int status = conductivity_build(conductivity, map, slab->rows, columns, slab->first_global_row, slab->total_rows);
+	if(status != 0)
+	{
+		fprintf(stderr, "Cannot allocate the coefficients of the conductivity map.\n");
+	}
+
+	sources_spans_free(&spans);
+	sources_free(&materials);
+	free(map);
+	return status;
+}
+
+void conductivity_destroy(struct conductivity* conductivity)
+{
+	free(conductivity->up);
+	free(conductivity->down);
+	free(conductivity->left);
+	free(conductivity->right);
+	free(conductivity->total);
+	memset(conductivity, 0, sizeof(*conductivity));
+}
+
+double conductivity_propagate(const double* restrict temperatures_last, double* restrict temperatures, const unsigned char* restrict fixed, int rows, int columns, const struct conductivity* conductivity)
+{
+	double my_temperature_change = 0.0;
+
+	#pragma omp parallel for reduction(max:my_temperature_change)
+	for(int i = 1; i <= rows; i++)
+	{
+		const double* restrict before = &temperatures_last[(size_t)(i - 1) * columns];
+		const double* restrict last = &temperatures_last[(size_t)i * columns];
+		const double* restrict after = &temperatures_last[(size_t)(i + 1) * columns];
+		double* restrict current = &temperatures[(size_t)i * columns];
+		const size_t row = (size_t)(i - 1) * columns;
+		const unsigned char* restrict my_fixed = &fixed[row];
+		const double* restrict up = &conductivity->up[row];
+		const double* restrict down = &conductivity->down[row];
+		const double* restrict left = &conductivity->left[row];
+		const double* restrict right = &conductivity->right[row];
+		const double* restrict total = &conductivity->total[row];
+
+		// Process the cell on the left edge, which has no left neighbour
+		current[0] = my_fixed[0] ? last[0] : (up[0] * before[0] + down[0] * after[0] + right[0] * last[1]) / total[0];
+		my_temperature_change = fmax(fabs(current[0] - last[0]), my_temperature_change);
+
+		// Process the cells between the edges, which each has four neighbours
+		#pragma omp simd reduction(max:my_temperature_change)
+		for(int j = 1; j < columns - 1; j++)
+		{
+			const double sum = up[j] * before[j] + down[j] * after[j] + left[j] * last[j - 1] + right[j] * last[j + 1];
+			current[j] = my_fixed[j] ? last[j] : sum / total[j];
+			my_temperature_change = fmax(fabs(current[j] - last[j]), my_temperature_change);
+		}
+
+		// Process the cell on the right edge, which has no right neighbour
+		const int end = columns - 1;
+		current[end] = my_fixed[end] ? last[end] : (up[end] * before[end] + down[end] * after[end] + left[end] * last[end - 1]) / total[end];
+		my_temperature_change = fmax(fabs(current[end] - last[end]), my_temperature_change);
+	}
+
+	return my_temperature_change;
+}
@@ -0,0 +1,70 @@
+/**
+ * @file conductivity.h
+ * @brief A plate made of several materials, each with its own conductivity, see --conductivity.
+ * @details The conductivity map is described with the syntax of a source file (see sources.h), the temperature of every shape being the conductivity of its cells; the cells no shape covers have a conductivity of 1. Every MPI process generates the map of its own rows from the description, and exchanges its boundary rows with its neighbours once so that every face of the slab has both its cells.
+ * The conductivity of the face between two cells is the harmonic mean of theirs, which is what a series of two materials conducts. A cell that is not a source takes the average of its neighbours weighted by the conductivities of its faces: (k_up * up + k_down * down + k_left * left + k_right * right) / (k_up + k_down + k_left + k_right). The faces beyond the left and right edges do not exist, and those beyond the top and bottom edges have the conductivity of the cell, towards a temperature of 0, so that a uniform map of conductivity 1 gives back exactly the rules of heat_propagate.
+ * The face conductivities and their sum are precomputed into separate planes, a structure of arrays, so that the sweep reads five contiguous rows of coefficients alongside the temperatures and stays vectorised.
+ **/
+
+#ifndef CONDUCTIVITY_H_INCLUDED
+#define CONDUCTIVITY_H_INCLUDED
+
+#include "slab.h"
+
+/**
+ * @brief The coefficients of the cells of a slab, every plane rows * columns without ghost rows.
+ **/
+struct conductivity
+{
+	/// The conductivity of the face with the cell above.
+	double* up;
+	/// The conductivity of the face with the cell below.
+	double* down;
+	/// The conductivity of the face with the cell on the left, 0 on the left edge.
+	double* left;
+	/// The conductivity of the face with the cell on the right, 0 on the right edge.
+	double* right;
+	/// The sum of the four.
+	double* total;
+};
+
+/**
+ * @brief Calculates the coefficients of a slab from the conductivities of its cells.
+ * @param[out] conductivity The coefficients.
+ * @param[in] map The conductivity of every cell, (rows + 2) * columns with ghost rows holding those of the neighbouring slabs; the ghost rows at the edges of the plate are not read.
+ * @param[in] rows The number of rows in the slab, ghost rows excluded.
+ * @param[in] columns The number of columns, at least 2.
+ * @param[in] first_global_row The index of the first row of the slab in the plate.
+ * @param[in] total_rows The number of rows in the plate.
+ * @return 0 on success, -1 if the memory cannot be allocated.
+ **/
+int conductivity_build(struct conductivity* conductivity, const double* map, int rows, int columns, int first_global_row, int total_rows);
+
+/**
+ * @brief Generates the conductivity map of a slab from its description and calculates its coefficients.
+ * @details This is a collective operation.
+ * @param[out] conductivity The coefficients.
+ * @param[in] slab The slab.
+ * @param[in] path The path of the description.
+ * @return 0 on success, -1 if the description cannot be read or has a conductivity that is not positive or follows a schedule, in which case a message has been printed on stderr, or if the memory cannot be allocated.
+ **/
+int conductivity_create(struct conductivity* conductivity, const struct slab* slab, const char* path);
+
+/**
+ * @brief Releases the coefficients.
+ **/
+void conductivity_destroy(struct conductivity* conductivity);
+
+/**
+ * @brief Propagates the temperatures of a C slab by one iteration like heat_propagate, with the coefficients of a conductivity map.
+ * @param[in] temperatures_last The temperatures at the previous iteration, ghost rows included.
+ * @param[out] temperatures The temperatures at this iteration; ghost rows are not written.
+ * @param[in] fixed Whether each cell of the slab is a fixed source, rows * columns without ghost rows.
+ * @param[in] rows The number of rows in the slab, ghost rows excluded.
+ * @param[in] columns The number of columns, at least 2.
+ * @param[in] conductivity The coefficients of the slab.
+ * @return The maximum absolute temperature change in the slab.
+ **/
+double conductivity_propagate(const double* restrict temperatures_last, double* restrict temperatures, const unsigned char* restrict fixed, int rows, int columns, const struct conductivity* conductivity);
+
+#endif
@@ -14,19 +14,164 @@
 #include <sched.h>
 #include <unistd.h>
 #include <string.h>
+#include <signal.h>
 
 #include "util.h"
+#include "options.h"
+#include "fingerprint.h"
+#include "kernels.h"
+#include "slab.h"
+#include "reference.h"
+#include "sor.h"
+#include "multigrid.h"
+#include "chebyshev.h"
+#include "cg.h"
+#include "adi.h"
+#include "warm_start.h"
+#include "parareal.h"
+#include "batch.h"
+#include "service.h"
+#include "sources.h"
+#include "conductivity.h"
+#include "boundary.h"
+#include "geometry.h"
+
+/// Printed at the beginning of every line of output: empty for a single run, the job for a batch.
+static const char* output_tag = "";
 
 /**
- * @argv[0] Name of the program
- * @argv[1] path to the dataset to load
+ * @brief The buffers of a run, which outlive it so that the next run of a plate of the same size on the same communicator skips their allocation and first touch.
  **/
-int main(int argc, char* argv[])
+struct workspace
 {
-	(void)argc;
-	(void)argv;
-	MPI_Init(NULL, NULL);
+	/// Tells whether the buffers are allocated.
+	int allocated;
+	/// The slab of this MPI process.
+	struct slab slab;
+	/// On master process only: contains all temperatures read from input file.
+	double* all_temperatures;
+	/// On master process only: the last snapshot made
+	double* snapshot;
+};
+
+/**
+ * @brief Tells every MPI process of a communicator whether all of them succeeded.
+ * @details This is a collective operation. A failure that only some MPI processes see, such as an allocation or a file read by the master MPI process alone, then ends the run on all of them instead of aborting the job, so that a batch carries on with its next job and the service with its next request.
+ * @param[in] my_success Whether this MPI process succeeded.
+ * @param[in] comm The communicator.
+ * @return 1 if every MPI process succeeded, 0 otherwise.
+ **/
+static int all_succeeded(int my_success, MPI_Comm comm)
+{
+	int success;
+	MPI_Allreduce(&my_success, &success, 1, MPI_INT, MPI_MIN, comm);
+	return success;
+}
+
+/**
+ * @brief What a run allocates besides its workspace, zeroed before anything is allocated so that a single release frees whatever was.
+ **/
+struct run
+{
+	/// On master process only: the temperature changes of the reference output.
+	struct reference reference;
+	/// The sources, kept for the whole run since a schedule compiles the rows of a moving source again.
+	struct sources sources;
+	/// The spans of the rows of the slab.
+	struct source_spans spans;
+	/// On master process only: the spans of the plate, to paint it.
+	struct source_spans plate_spans;
+	/// The coefficients of the conductivity map.
+	struct conductivity conductivity;
+	/// The metal of the rows of the slab.
+	struct geometry geometry;
+	/// The coarse levels of multigrid.
+	struct multigrid multigrid;
+	/// The vectors of the conjugate gradients.
+	struct cg cg;
+	/// The column decomposition of ADI.
+	struct adi adi;
+};
+
+/**
+ * @brief Releases what a run allocated.
+ **/
+static void run_release(struct run* run)
+{
+	reference_free(&run->reference);
+	sources_free(&run->sources);
+	sources_spans_free(&run->spans);
+	sources_spans_free(&run->plate_spans);
+	conductivity_destroy(&run->conductivity);
+	geometry_destroy(&run->geometry);
+	multigrid_destroy(&run->multigrid);
+	cg_destroy(&run->cg);
+	adi_destroy(&run->adi);
+}
+
+/**
+ * @brief Releases the buffers of a workspace, if allocated.
+ **/
+static void workspace_release(struct workspace* workspace)
+{
+	if(workspace->allocated)
+	{
+		slab_destroy(&workspace->slab);
+		free(workspace->all_temperatures);
+		free(workspace->snapshot);
+	}
+	memset(workspace, 0, sizeof(*workspace));
+}
+
+/**
+ * @brief Makes sure a workspace holds the buffers of a plate, reusing those of the last run when it has the same size.
+ * @details This is a collective operation.
+ * @return 0 on success, -1 on every MPI process if the plate cannot be decomposed across the MPI processes or allocated.
+ **/
+static int workspace_prepare(struct workspace* workspace, const struct options* options, MPI_Comm comm, int root)
+{
+	if(workspace->allocated && workspace->slab.comm == comm && workspace->slab.total_rows == options->rows && workspace->slab.columns == options->columns)
+	{
+		// Whatever the last run left in the ghost rows of the plate edges must be back at 0
+		struct slab* slab = &workspace->slab;
+		memset(slab->temperatures_last, 0, slab->columns * sizeof(double));
+		memset(&slab->temperatures_last[(size_t)(slab->rows + 1) * slab->columns], 0, slab->columns * sizeof(double));
+		memset(slab->temperatures, 0, slab->columns * sizeof(double));
+		memset(&slab->temperatures[(size_t)(slab->rows + 1) * slab->columns], 0, slab->columns * sizeof(double));
+		return 0;
+	}
+
+	workspace_release(workspace);
+	int prepared = slab_create(&workspace->slab, comm, options->rows, options->columns) == 0;
+	workspace->allocated = prepared;
+	if(prepared && workspace->slab.my_rank == root)
+	{
+		workspace->all_temperatures = malloc((size_t)options->rows * options->columns * sizeof(double));
+		workspace->snapshot = malloc((size_t)options->rows * options->columns * sizeof(double));
+		if(workspace->all_temperatures == NULL || workspace->snapshot == NULL)
+		{
+			fprintf(stderr, "%sCannot allocate the %dx%d plate.\n", output_tag, options->rows, options->columns);
+			prepared = 0;
+		}
+	}
+	if(!all_succeeded(prepared, comm))
+	{
+		workspace_release(workspace);
+		return -1;
+	}
+	return 0;
+}
 
+/**
+ * @brief Runs the simulation with a set of options on the MPI processes of a communicator.
+ * @details This is a collective operation; rank 0 of the communicator is the master MPI process.
+ * @param[in] options The options of the run.
+ * @param[in] comm The communicator.
+ * @param[in,out] workspace The buffers of the run, kept for the next one.
+ * @return EXIT_SUCCESS, or EXIT_FAILURE on every MPI process if the run cannot start or its output differs from the reference.
+ **/
+static int run_simulation(struct options options, MPI_Comm comm, struct workspace* workspace)
+{
 	/////////////////////////////////////////////////////
 	// -- PREPARATION 1: COLLECT USEFUL INFORMATION -- //
 	/////////////////////////////////////////////////////
@@ -35,22 +180,67 @@ int main(int argc, char* argv[])
 
 	// The rank of the MPI process in charge of this instance
 	int my_rank;
-	MPI_Comm_rank(MPI_COMM_WORLD, &my_rank);
+	MPI_Comm_rank(comm, &my_rank);
 
-	// Number of MPI processes in total, commonly called "comm_size" for "communicator size".
-	int comm_size;
-	MPI_Comm_size(MPI_COMM_WORLD, &comm_size);
+	// Without any other stopping criterion, the run stops after MAX_TIME seconds like it always did
+	if(options.max_time == 0.0 && options.max_iterations == 0 && options.tolerance == 0.0)
+	{
+		options.max_time = MAX_TIME;
+	}
+
+	// Each run of the service or of a batch may choose how often it is told about its progress
+	if(options.snapshot_interval == 0)
+	{
+		options.snapshot_interval = SNAPSHOT_INTERVAL;
+	}
 
-	/// Rank of the first MPI process
-	const int FIRST_PROCESS_RANK = 0;
-	/// Rank of the last MPI process
-	const int LAST_PROCESS_RANK = comm_size - 1;
+	// The optimal relaxation factor depends on the plate only, so everybody calculates the same one
+	if(options.solver == SOLVER_SOR && options.omega == 0.0)
+	{
+		options.omega = sor_optimal_omega(options.rows);
+	}
 
-	// Rank of my up neighbour if any
-	int up_neighbour_rank = (my_rank == FIRST_PROCESS_RANK) ? MPI_PROC_NULL : my_rank - 1;
-	
-	// Rank of my down neighbour if any
-	int down_neighbour_rank = (my_rank == LAST_PROCESS_RANK) ? MPI_PROC_NULL : my_rank + 1;
+	// Parareal splits the MPI processes into as many groups as time slices, which everybody can check before anything is allocated
+	if(options.parareal_slices > 0)
+	{
+		int comm_size;
+		MPI_Comm_size(comm, &comm_size);
+		if(comm_size % options.parareal_slices != 0 || options.rows < 2 * (comm_size / options.parareal_slices) || options.columns < 4)
+		{
+			if(my_rank == MASTER_PROCESS_RANK)
+			{
+				fprintf(stderr, "%sParareal needs a number of MPI processes that is a multiple of %d, and at least 2 rows per MPI process of a group and 4 columns.\n", output_tag, options.parareal_slices);
+			}
+			return EXIT_FAILURE;
+		}
+	}
+
+	// The rows are split across however many MPI processes there are; the slab knows my rows and my neighbours.
+	if(workspace_prepare(workspace, &options, comm, MASTER_PROCESS_RANK) != 0)
+	{
+		if(my_rank == MASTER_PROCESS_RANK)
+		{
+			fprintf(stderr, "%sCannot decompose a %dx%d plate across the MPI processes or allocate it.\n", output_tag, options.rows, options.columns);
+		}
+		return EXIT_FAILURE;
+	}
+
+	struct run run;
+	memset(&run, 0, sizeof(run));
+
+	// The master MPI process loads the reference now so that a wrong path is reported before any work is done
+	int reference_loaded = 1;
+	if(options.reference_path != NULL && my_rank == MASTER_PROCESS_RANK && reference_load(&run.reference, options.reference_path) != 0)
+	{
+		fprintf(stderr, "%sCannot read the reference output \"%s\".\n", output_tag, options.reference_path);
+		reference_loaded = 0;
+	}
+	MPI_Bcast(&reference_loaded, 1, MPI_INT, MASTER_PROCESS_RANK, comm);
+	if(!reference_loaded)
+	{
+		run_release(&run);
+		return EXIT_FAILURE;
+	}
 
 	//report_placement();
 
@@ -58,20 +248,77 @@ int main(int argc, char* argv[])
 	// -- PREPARATION 2: INITIALISE TEMPERATURES ON MASTER PROCESS -- //
 	////////////////////////////////////////////////////////////////////
 
-	/// Array that will contain my part chunk. It will include the 2 ghost rows (1 up, 1 down)
-	double temperatures[ROWS_PER_MPI_PROCESS+2][COLUMNS_PER_MPI_PROCESS];
-	/// Temperatures from the previous iteration, same dimensions as the array above.
-	double temperatures_last[ROWS_PER_MPI_PROCESS+2][COLUMNS_PER_MPI_PROCESS];
+	// The slab is the one of the workspace, handed back at the end since swapping its buffers changes it
+	struct slab slab = workspace->slab;
 	/// On master process only: contains all temperatures read from input file.
-	double all_temperatures[ROWS][COLUMNS];
+	double* all_temperatures = workspace->all_temperatures;
+	/// On master process only: the last snapshot made
+	double* snapshot = workspace->snapshot;
+
+	// Periodic top and bottom edges link the first and last MPI processes; the slab of the workspace may have been linked by the run before
+	boundary_link(&options.boundary, &slab);
+	const int default_boundary = boundary_is_default(&options.boundary);
+
+	// Every MPI process reads the sources itself, like the command line, and compiles the spans of its rows; the master MPI process also those of the plate, to paint it
+	if(options.sources_path != NULL)
+	{
+		if(!all_succeeded(sources_load(&run.sources, options.sources_path) == 0, comm))
+		{
+			run_release(&run);
+			return EXIT_FAILURE;
+		}
+
+		// Multigrid, the conjugate gradients and ADI build their operators from the fixed cells once, before the first iteration
+		if(sources_scheduled(&run.sources) && (options.solver == SOLVER_MULTIGRID || options.solver == SOLVER_CG || options.solver == SOLVER_ADI))
+		{
+			if(my_rank == MASTER_PROCESS_RANK)
+			{
+				fprintf(stderr, "%sThe sources of \"%s\" follow a schedule, which multigrid, cg and adi do not support.\n", output_tag, options.sources_path);
+			}
+			run_release(&run);
+			return EXIT_FAILURE;
+		}
+		const int compiled = sources_compile(&run.sources, &run.spans, slab.first_global_row, slab.rows, slab.columns, 0) == 0 && (my_rank != MASTER_PROCESS_RANK || sources_compile(&run.sources, &run.plate_spans, 0, options.rows, options.columns, 0) == 0);
+		if(!compiled)
+		{
+			fprintf(stderr, "%sCannot allocate the spans of the sources.\n", output_tag);
+		}
+		if(!all_succeeded(compiled, comm))
+		{
+			run_release(&run);
+			return EXIT_FAILURE;
+		}
+	}
+
+	// Every MPI process generates the conductivity of its rows and exchanges those around its slab, once for the whole run
+	if(options.conductivity_path != NULL && !all_succeeded(conductivity_create(&run.conductivity, &slab, options.conductivity_path) == 0, comm))
+	{
+		run_release(&run);
+		return EXIT_FAILURE;
+	}
+
+	// Likewise the metal of its rows, and of those around its slab
+	if(options.geometry_path != NULL && !all_succeeded(geometry_create(&run.geometry, &slab, options.geometry_path) == 0, comm))
+	{
+		run_release(&run);
+		return EXIT_FAILURE;
+	}
 
 	// The master MPI process will read a chunk from the file, send it to the corresponding MPI process and repeat until all chunks are read.
 	if(my_rank == MASTER_PROCESS_RANK)
 	{
-		initialise_temperatures(all_temperatures);
+		if(options.sources_path != NULL)
+		{
+			memset(all_temperatures, 0, (size_t)options.rows * options.columns * sizeof(double));
+			sources_paint(&run.plate_spans, all_temperatures, options.columns);
+		}
+		else
+		{
+			initialise_plate(all_temperatures, options.rows, options.columns);
+		}
 	}
 
-	MPI_Barrier(MPI_COMM_WORLD);
+	MPI_Barrier(comm);
 
 	///////////////////////////////////////////
 	//     ^                                 //
@@ -80,62 +327,88 @@ int main(int argc, char* argv[])
 	//  /  o  \                              //
 	// /_______\                             //
 	///////////////////////////////////////////
-	
+
 	////////////////////////////////////////////////////////
 	// -- TASK 1: DISTRIBUTE DATA TO ALL MPI PROCESSES -- //
 	////////////////////////////////////////////////////////
 	double total_time_so_far = 0.0;
 	double start_time = MPI_Wtime();
 
+	// Each MPI process receives its chunk in both buffers, the ghost rows stay at 0 until exchanged.
+	slab_scatter(&slab, all_temperatures, MASTER_PROCESS_RANK);
+
+	// The sources are not necessarily at MAX_TEMPERATURE, so the spans tell which cells are fixed
+	if(options.sources_path != NULL)
+	{
+		sources_mark(&run.spans, slab.fixed, slab.columns);
+	}
+
+	// The cells cut out of the plate stay at 0 in both buffers, since the kernel never writes them
+	if(options.geometry_path != NULL)
+	{
+		geometry_clear(&run.geometry, &slab.temperatures_last[slab.columns], slab.columns);
+		geometry_clear(&run.geometry, &slab.temperatures[slab.columns], slab.columns);
+	}
+
 	if(my_rank == MASTER_PROCESS_RANK)
 	{
-		for(int i = 0; i < comm_size; i++)
+		printf("%sData acquisition complete.\n", output_tag);
+	}
+
+	// The warm start replaces the initial temperatures, from which every solver below prepares itself; the snapshot buffer is not used yet
+	if(options.warm_start_factor > 0)
+	{
+		int warm_start_iterations = warm_start(&slab, all_temperatures, snapshot, options.warm_start_factor, options.tolerance, MASTER_PROCESS_RANK);
+		if(my_rank == MASTER_PROCESS_RANK)
 		{
-			// Is the i'th chunk meant for me, the master MPI process?
-			if(i != my_rank)
+			if(warm_start_iterations < 0)
 			{
-				// No, so send the corresponding chunk to that MPI process.
-				MPI_Ssend(&all_temperatures[i * ROWS_PER_MPI_PROCESS][0], ROWS_PER_MPI_PROCESS * COLUMNS_PER_MPI_PROCESS, MPI_DOUBLE, i, 0, MPI_COMM_WORLD);
+				printf("%sThe plate cannot be coarsened by %d across the MPI processes, starting from the plate itself.\n", output_tag, options.warm_start_factor);
 			}
 			else
 			{
-				// Yes, let's copy it straight for the array in which we read the file into.
-				for(int j = 1; j <= ROWS_PER_MPI_PROCESS; j++)
-				{
-					for(int k = 0; k < COLUMNS_PER_MPI_PROCESS; k++)
-					{
-						temperatures_last[j][k] = all_temperatures[j-1][k];
-					}
-				}
+				printf("%sWarm start complete: the plate coarsened by %d converged after %d iterations.\n", output_tag, options.warm_start_factor, warm_start_iterations);
 			}
 		}
 	}
-	else
+
+	// The coarse levels of multigrid are built from the fixed cells of the plate, which are known once it is scattered
+	if(options.solver == SOLVER_MULTIGRID && multigrid_create(&run.multigrid, &slab, MASTER_PROCESS_RANK) != 0)
 	{
-		// Receive my chunk.
-		MPI_Recv(&temperatures_last[1][0], ROWS_PER_MPI_PROCESS * COLUMNS_PER_MPI_PROCESS, MPI_DOUBLE, MASTER_PROCESS_RANK, MPI_ANY_TAG, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+		// multigrid_create fails on every MPI process at once, like the other solvers
+		if(my_rank == MASTER_PROCESS_RANK)
+		{
+			fprintf(stderr, "%sCannot allocate the coarse levels of multigrid.\n", output_tag);
+		}
+		run_release(&run);
+		return EXIT_FAILURE;
 	}
-	// MPI_Scatter(all_temperatures, ROWS_PER_MPI_PROCESS * COLUMNS_PER_MPI_PROCESS, MPI_DOUBLE, &temperatures_last[1][0], ROWS_PER_MPI_PROCESS * COLUMNS_PER_MPI_PROCESS, MPI_DOUBLE, MASTER_PROCESS_RANK, MPI_COMM_WORLD);
 
-
-	// Copy the temperatures into the current iteration temperature as well
-	#pragma omp parallel for shared(temperatures, temperatures_last, ROWS_PER_MPI_PROCESS, ROWS_PER_MPI_PROCESS) collapse(2)
-	for(int i = 1; i <= ROWS_PER_MPI_PROCESS; i++)
+	// Likewise the initial residual of the conjugate gradients
+	if(options.solver == SOLVER_CG && cg_create(&run.cg, &slab) != 0)
 	{
-		for(int j = 0; j < COLUMNS_PER_MPI_PROCESS; j++)
+		if(my_rank == MASTER_PROCESS_RANK)
 		{
-			temperatures[i][j] = temperatures_last[i][j];
+			fprintf(stderr, "%sCannot allocate the vectors of the conjugate gradients.\n", output_tag);
 		}
+		run_release(&run);
+		return EXIT_FAILURE;
 	}
 
-	if(my_rank == MASTER_PROCESS_RANK)
+	// And the fixed cells of the column decomposition of ADI
+	if(options.solver == SOLVER_ADI && adi_create(&run.adi, &slab, options.adi_time_step) != 0)
 	{
-		printf("Data acquisition complete.\n");
+		if(my_rank == MASTER_PROCESS_RANK)
+		{
+			fprintf(stderr, "%sCannot allocate the column decomposition of ADI.\n", output_tag);
+		}
+		run_release(&run);
+		return EXIT_FAILURE;
 	}
 
 	// Wait for everybody to receive their part before we can start processing
-	MPI_Barrier(MPI_COMM_WORLD);
-	
+	MPI_Barrier(comm);
+
 	/////////////////////////////
 	// TASK 2: DATA PROCESSING //
 	/////////////////////////////
@@ -143,137 +416,214 @@ int main(int argc, char* argv[])
 	/// Maximum temperature change observed across all MPI processes
 	double global_temperature_change;
 	/// Maximum temperature change for us
-	double my_temperature_change; 
-	/// The last snapshot made
-	double snapshot[ROWS][COLUMNS];
-
-	while(total_time_so_far < MAX_TIME)
+	double my_temperature_change;
+	/// Set once the maximum temperature change overall has fallen below the tolerance
+	int converged = 0;
+	/// The spectral radius of the Jacobi iteration on this plate, which drives the Chebyshev acceleration
+	const double chebyshev_rho = chebyshev_spectral_radius(options.rows);
+	/// The extrapolation factor of the last Chebyshev iteration
+	double chebyshev_factor = 1.0;
+	/// EXIT_FAILURE once the run has to stop early
+	int status = EXIT_SUCCESS;
+
+	// Parareal runs all the iterations itself from the plate; its result is scattered like the initial plate and the loop below has nothing left to do
+	if(options.parareal_slices > 0)
 	{
-		my_temperature_change = 0.0;
-
-		// ////////////////////////////////////////
-		// -- SUBTASK 1: EXCHANGE GHOST CELLS -- //
-		// ////////////////////////////////////////
-
-		// Send data to up neighbour for its ghost cells. If my up_neighbour_rank is MPI_PROC_NULL, this MPI_Ssend will do nothing.
-		MPI_Ssend(&temperatures[1][0], COLUMNS_PER_MPI_PROCESS, MPI_DOUBLE, up_neighbour_rank, 0, MPI_COMM_WORLD);
-
-		// Receive data from down neighbour to fill our ghost cells. If my down_neighbour_rank is MPI_PROC_NULL, this MPI_Recv will do nothing.
-		MPI_Recv(&temperatures_last[ROWS_PER_MPI_PROCESS+1][0], COLUMNS_PER_MPI_PROCESS, MPI_DOUBLE, down_neighbour_rank, MPI_ANY_TAG, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
-
-		// Send data to down neighbour for its ghost cells. If my down_neighbour_rank is MPI_PROC_NULL, this MPI_Ssend will do nothing.
-		MPI_Ssend(&temperatures[ROWS_PER_MPI_PROCESS][0], COLUMNS_PER_MPI_PROCESS, MPI_DOUBLE, down_neighbour_rank, 0, MPI_COMM_WORLD);
-
-		// Receive data from up neighbour to fill our ghost cells. If my up_neighbour_rank is MPI_PROC_NULL, this MPI_Recv will do nothing.
-		MPI_Recv(&temperatures_last[0][0], COLUMNS_PER_MPI_PROCESS, MPI_DOUBLE, up_neighbour_rank, MPI_ANY_TAG, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
-
-		// ///////////// Using SendRecv
-		// // Send data to up neighbour from down neighbour
-		// MPI_Sendrecv(&temperatures[1][0], COLUMNS_PER_MPI_PROCESS, MPI_DOUBLE, up_neighbour_rank, 0, &temperatures_last[ROWS_PER_MPI_PROCESS+1][0], COLUMNS_PER_MPI_PROCESS, MPI_DOUBLE, down_neighbour_rank, 0, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
-		// // Send data to down neighbour from up neighbour
-		// MPI_Sendrecv(&temperatures[ROWS_PER_MPI_PROCESS][0], COLUMNS_PER_MPI_PROCESS, MPI_DOUBLE, down_neighbour_rank, 0, &temperatures_last[0][0], COLUMNS_PER_MPI_PROCESS, MPI_DOUBLE, up_neighbour_rank, 0, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
-
-		/////////////////////////////////////////////
-		// -- SUBTASK 2: PROPAGATE TEMPERATURES -- //
-		/////////////////////////////////////////////
-		#pragma omp parallel for shared(temperatures, temperatures_last, ROWS_PER_MPI_PROCESS, ROWS_PER_MPI_PROCESS, MAX_TEMPERATURE) collapse(2)
-		for(int i = 1; i <= ROWS_PER_MPI_PROCESS; i++)
+		const int corrections = parareal_run(all_temperatures, options.rows, options.columns, options.max_iterations, options.parareal_slices, options.parareal_corrections, MASTER_PROCESS_RANK, comm);
+		if(corrections < 0)
 		{
-			// Process all cells between the first and last columns excluded, which each has both left and right neighbours
-			for(int j = 1; j < COLUMNS_PER_MPI_PROCESS - 1; j++)
+			if(my_rank == MASTER_PROCESS_RANK)
 			{
-				if(temperatures[i][j] != MAX_TEMPERATURE)
-				{
-					temperatures[i][j] = 0.25 * (temperatures_last[i-1][j  ] +
-												 temperatures_last[i+1][j  ] +
-												 temperatures_last[i  ][j-1] +
-												 temperatures_last[i  ][j+1]);
-				}
+				fprintf(stderr, "%sCannot allocate the time slices of Parareal.\n", output_tag);
 			}
-			
+			run_release(&run);
+			return EXIT_FAILURE;
 		}
-
-		#pragma omp parallel for shared(temperatures, temperatures_last, ROWS_PER_MPI_PROCESS, ROWS_PER_MPI_PROCESS, MAX_TEMPERATURE)
-		for(int i = 1; i <= ROWS_PER_MPI_PROCESS; i++)
+		slab_scatter(&slab, all_temperatures, MASTER_PROCESS_RANK);
+		iteration_count = options.max_iterations;
+		if(my_rank == MASTER_PROCESS_RANK)
+		{
+			total_time_so_far = MPI_Wtime() - start_time;
+			printf("%sParareal complete: %d time slices, %d corrections.\n", output_tag, options.parareal_slices, corrections);
+		}
+		// The hash is labelled like that of the last iteration of the loop below, so that it compares with the plain run
+		if(options.hash)
 		{
-			// Process the cell at the first column, which has no left neighbour
-			if(temperatures[i][0] != MAX_TEMPERATURE)
+			uint64_t hash = fingerprint_field(&slab.temperatures_last[slab.columns], slab.rows, slab.columns, slab.first_global_row, comm, MASTER_PROCESS_RANK);
+			if(my_rank == MASTER_PROCESS_RANK)
 			{
-				temperatures[i][0] = (temperatures_last[i-1][0] +
-									  temperatures_last[i+1][0] +
-									  temperatures_last[i  ][1]) / 3.0;
+				printf("%sHash %d: 0x%016" PRIx64 "\n", output_tag, iteration_count - 1, hash);
 			}
 		}
-		#pragma omp parallel for shared(temperatures, temperatures_last, ROWS_PER_MPI_PROCESS, ROWS_PER_MPI_PROCESS, MAX_TEMPERATURE)
-		for(int i = 1; i <= ROWS_PER_MPI_PROCESS; i++)
+	}
+
+	while(!converged && (options.max_iterations == 0 || iteration_count < options.max_iterations) && (options.max_time == 0.0 || total_time_so_far < options.max_time))
+	{
+		// With a tolerance, the maximum temperature change overall is only needed at snapshots and checks; the other iterations skip the reduction and the timer broadcast.
+		const int snapshot_iteration = iteration_count % options.snapshot_interval == 0;
+		const int reduction_iteration = options.tolerance == 0.0 || snapshot_iteration || iteration_count % options.check_interval == 0;
+
+		// The sources that switch or move at this iteration update the rows they leave and enter before any cell is propagated
+		// Everybody knows these iterations from the schedule, so only they tell each other whether the update succeeded
+		if(options.sources_path != NULL && iteration_count > 0 && iteration_count >= run.spans.next_change)
 		{
-			// Process the cell at the last column, which has no right neighbour
-			if(temperatures[i][COLUMNS_PER_MPI_PROCESS - 1] != MAX_TEMPERATURE)
+			const int updated = sources_update(&run.sources, &run.spans, iteration_count, &slab.temperatures_last[slab.columns], &slab.temperatures[slab.columns], slab.fixed) >= 0;
+			if(!updated)
+			{
+				fprintf(stderr, "%sCannot allocate the spans of the sources.\n", output_tag);
+			}
+			if(!all_succeeded(updated, comm))
 			{
-				temperatures[i][COLUMNS_PER_MPI_PROCESS - 1] = (temperatures_last[i-1][COLUMNS_PER_MPI_PROCESS - 1] +
-															    temperatures_last[i+1][COLUMNS_PER_MPI_PROCESS - 1] +
-															    temperatures_last[i  ][COLUMNS_PER_MPI_PROCESS - 2]) / 3.0;
+				status = EXIT_FAILURE;
+				break;
 			}
 		}
 
-		// Start the gather of the snapshot here
-		MPI_Request gather_request;
-		if(iteration_count % SNAPSHOT_INTERVAL == 0)
+		if(options.solver == SOLVER_SOR)
 		{
-			MPI_Igather(&temperatures[1][0], ROWS_PER_MPI_PROCESS * COLUMNS_PER_MPI_PROCESS, MPI_DOUBLE, snapshot, ROWS_PER_MPI_PROCESS * COLUMNS_PER_MPI_PROCESS, MPI_DOUBLE, MASTER_PROCESS_RANK, MPI_COMM_WORLD, &gather_request);
+			// Both colours are updated in place in the last temperatures, each once the ghost rows hold the latest cells of the other colour.
+			slab_exchange_ghost_rows(&slab, slab.temperatures_last);
+			my_temperature_change = sor_sweep(slab.temperatures_last, slab.fixed, slab.rows, slab.columns, slab.first_global_row, SOR_RED, options.omega);
+			slab_exchange_ghost_rows(&slab, slab.temperatures_last);
+			my_temperature_change = fmax(sor_sweep(slab.temperatures_last, slab.fixed, slab.rows, slab.columns, slab.first_global_row, SOR_BLACK, options.omega), my_temperature_change);
 		}
-
-
-		///////////////////////////////////////////////////////
-		// -- SUBTASK 3: CALCULATE MAX TEMPERATURE CHANGE -- //
-		///////////////////////////////////////////////////////
-		my_temperature_change = 0.0;
-		#pragma omp parallel for shared(temperatures, temperatures_last, ROWS_PER_MPI_PROCESS, ROWS_PER_MPI_PROCESS) collapse(2) reduciton(max:my_temperature_change)
-		for(int i = 1; i <= ROWS_PER_MPI_PROCESS; i++)
+		else if(options.solver == SOLVER_MULTIGRID)
 		{
-			for(int j = 0; j < COLUMNS_PER_MPI_PROCESS; j++)
+			// A V-cycle updates the last temperatures in place
+			my_temperature_change = multigrid_cycle(&run.multigrid, &slab);
+		}
+		else if(options.solver == SOLVER_CHEBYSHEV)
+		{
+			// Same exchange and swap as the Jacobi iteration; the buffer written still holds the temperatures of the iteration before the last one, from which the new ones are extrapolated.
+			slab_exchange_ghost_rows(&slab, slab.temperatures_last);
+			chebyshev_factor = chebyshev_omega(iteration_count, chebyshev_rho, chebyshev_factor);
+			my_temperature_change = chebyshev_sweep(slab.temperatures_last, slab.temperatures, slab.fixed, slab.rows, slab.columns, chebyshev_factor);
+			slab_swap(&slab);
+		}
+		else if(options.solver == SOLVER_CG)
+		{
+			// An iteration of the conjugate gradients updates the last temperatures in place
+			my_temperature_change = cg_iterate(&run.cg, &slab);
+		}
+		else if(options.solver == SOLVER_ADI)
+		{
+			// A time step writes the new temperatures like the Jacobi iteration, and exchanges what it needs itself
+			my_temperature_change = adi_step(&run.adi, &slab);
+			slab_swap(&slab);
+		}
+		else
+		{
+			// ////////////////////////////////////////
+			// -- SUBTASK 1: EXCHANGE GHOST CELLS -- //
+			// ////////////////////////////////////////
+			slab_exchange_ghost_rows(&slab, slab.temperatures_last);
+			if(!default_boundary)
+			{
+				boundary_fill_ghost_rows(&options.boundary, &slab, slab.temperatures_last);
+			}
+
+			/////////////////////////////////////////////////////////////////////////////////
+			// -- SUBTASKS 2 & 3: PROPAGATE TEMPERATURES, CALCULATE MAX TEMPERATURE CHANGE -- //
+			/////////////////////////////////////////////////////////////////////////////////
+			if(options.conductivity_path != NULL)
+			{
+				my_temperature_change = conductivity_propagate(slab.temperatures_last, slab.temperatures, slab.fixed, slab.rows, slab.columns, &run.conductivity);
+			}
+			else if(options.geometry_path != NULL)
+			{
+				my_temperature_change = geometry_propagate(slab.temperatures_last, slab.temperatures, slab.rows, slab.columns, &run.geometry);
+			}
+			else if(options.sources_path != NULL)
+			{
+				my_temperature_change = sources_propagate(slab.temperatures_last, slab.temperatures, slab.rows, slab.columns, &run.spans);
+			}
+			else if(!default_boundary)
 			{
-				my_temperature_change = fmax(fabs(temperatures[i][j] - temperatures_last[i][j]), my_temperature_change);
-				temperatures_last[i][j] = temperatures[i][j];
+				my_temperature_change = boundary_propagate(slab.temperatures_last, slab.temperatures, slab.rows, slab.columns, &options.boundary);
 			}
+			else
+			{
+				my_temperature_change = heat_propagate(slab.temperatures_last, slab.temperatures, slab.rows, slab.columns);
+			}
+
+			// The temperatures just calculated become the last ones; swapping the buffers replaces the copy.
+			slab_swap(&slab);
 		}
 
+		// Start the gather of the snapshot here
+		MPI_Request gather_request;
+		if(snapshot_iteration)
+		{
+			MPI_Igatherv(&slab.temperatures_last[slab.columns], slab.rows * slab.columns, MPI_DOUBLE, snapshot, slab.cell_counts, slab.cell_offsets, MPI_DOUBLE, MASTER_PROCESS_RANK, comm, &gather_request);
+		}
 
 		//////////////////////////////////////////////////////////
 		// -- SUBTASK 4: FIND MAX TEMPERATURE CHANGE OVERALL -- //
 		//////////////////////////////////////////////////////////
-		MPI_Request allreduce_request;
-		MPI_Iallreduce(&my_temperature_change, &global_temperature_change, 1, MPI_DOUBLE, MPI_MAX, MPI_COMM_WORLD, &allreduce_request);
-	
-		// MPI_Allreduce(&my_temperature_change, &global_temperature_change, 1, MPI_DOUBLE, MPI_MAX, MPI_COMM_WORLD);
-
-
+		if(reduction_iteration)
+		{
+			MPI_Request allreduce_request;
+			MPI_Iallreduce(&my_temperature_change, &global_temperature_change, 1, MPI_DOUBLE, MPI_MAX, comm, &allreduce_request);
 
-		// Wait for the all reduce to find the max temp to complete
-		MPI_Wait(&allreduce_request, MPI_STATUS_IGNORE);
+			// Wait for the all reduce to find the max temp to complete
+			MPI_Wait(&allreduce_request, MPI_STATUS_IGNORE);
+		}
 
 		///////////////////////////////////
 		// -- SUBTASK 6: GET SNAPSHOT -- //
 		///////////////////////////////////
-		if(iteration_count % SNAPSHOT_INTERVAL == 0)
-		{	 	
+		if(snapshot_iteration)
+		{
+			// Wait there to gather the snapshot; everybody must complete it before touching their temperatures again
+			MPI_Wait(&gather_request, MPI_STATUS_IGNORE);
 		 	if(my_rank == MASTER_PROCESS_RANK)
-			{	
-				// Wait there to gather the snapshot
-				MPI_Wait(&gather_request, MPI_STATUS_IGNORE);
-				printf("Iteration %d: %.18f\n", iteration_count, global_temperature_change);
+			{
+				printf("%sIteration %d: %.18f\n", output_tag, iteration_count, global_temperature_change);
+			}
+			// Stop burning allocation time as soon as the output is known to be wrong
+			if(options.reference_path != NULL)
+			{
+				int matches = my_rank != MASTER_PROCESS_RANK || reference_check(&run.reference, iteration_count, global_temperature_change) == 0;
+				MPI_Bcast(&matches, 1, MPI_INT, MASTER_PROCESS_RANK, comm);
+				if(!matches)
+				{
+					fflush(stdout);
+					status = EXIT_FAILURE;
+					break;
+				}
+			}
+			if(options.hash)
+			{
+				uint64_t hash = fingerprint_field(&slab.temperatures_last[slab.columns], slab.rows, slab.columns, slab.first_global_row, comm, MASTER_PROCESS_RANK);
+				if(my_rank == MASTER_PROCESS_RANK)
+				{
+					printf("%sHash %d: 0x%016" PRIx64 "\n", output_tag, iteration_count, hash);
+				}
+			}
+			// Snapshots are the progress of the run, which a client of the service or a batch may be following
+			if(my_rank == MASTER_PROCESS_RANK)
+			{
+				fflush(stdout);
 			}
-			// MPI_Gather(&temperatures[1][0], ROWS_PER_MPI_PROCESS * COLUMNS_PER_MPI_PROCESS, MPI_DOUBLE, snapshot, ROWS_PER_MPI_PROCESS * COLUMNS_PER_MPI_PROCESS, MPI_DOUBLE, MASTER_PROCESS_RANK, MPI_COMM_WORLD);
 		}
 
-		// Calculate the total time spent processing
-		if(my_rank == MASTER_PROCESS_RANK)
+		if(reduction_iteration)
 		{
-			total_time_so_far = MPI_Wtime() - start_time;
-		}
+			// Everybody has the same maximum temperature change overall, so everybody takes the same decision
+			if(global_temperature_change < options.tolerance)
+			{
+				converged = 1;
+			}
+
+			// Calculate the total time spent processing
+			if(my_rank == MASTER_PROCESS_RANK)
+			{
+				total_time_so_far = MPI_Wtime() - start_time;
+			}
 
-		// Send total timer to everybody so they too can exit the loop if more than the allowed runtime has elapsed already
-		MPI_Bcast(&total_time_so_far, 1, MPI_DOUBLE, MASTER_PROCESS_RANK, MPI_COMM_WORLD);
+			// Send total timer to everybody so they too can exit the loop if more than the allowed runtime has elapsed already
+			MPI_Bcast(&total_time_so_far, 1, MPI_DOUBLE, MASTER_PROCESS_RANK, comm);
+		}
 
 		// Update the iteration number
 		iteration_count++;
@@ -290,12 +640,295 @@ int main(int argc, char* argv[])
 	/////////////////////////////////////////
 	// -- FINALISATION 2: PRINT SUMMARY -- //
 	/////////////////////////////////////////
+	// A run stopped early has already said why, and its field is not worth writing
+	if(status == EXIT_SUCCESS && my_rank == MASTER_PROCESS_RANK)
+	{
+		printf("%sThe program took %.2f seconds in total and executed %d iterations.\n", output_tag, total_time_so_far, iteration_count);
+		if(converged)
+		{
+			printf("%sConverged below %g after %d iterations, time to solution %.6f seconds, last maximum temperature change %.18f.\n", output_tag, options.tolerance, iteration_count, total_time_so_far, global_temperature_change);
+		}
+		else if(options.tolerance > 0.0)
+		{
+			printf("%sDid not converge below %g, last maximum temperature change checked %.18f.\n", output_tag, options.tolerance, global_temperature_change);
+		}
+	}
+
+	if(status == EXIT_SUCCESS && options.dump_path != NULL)
+	{
+		if(fingerprint_write_field(options.dump_path, &slab.temperatures_last[slab.columns], slab.rows, slab.columns, slab.first_global_row, slab.total_rows, iteration_count, comm) != MPI_SUCCESS && my_rank == MASTER_PROCESS_RANK)
+		{
+			fprintf(stderr, "%sCannot write the field to \"%s\".\n", output_tag, options.dump_path);
+		}
+	}
+
+	run_release(&run);
+	workspace->slab = slab;
+
+	return status;
+}
+
+/**
+ * @brief Runs the jobs of a job list, on groups of MPI processes side by side.
+ * @details The MPI processes are split into groups of consecutive ranks, and job k runs on group k % groups with its own communicator. Every line a job prints is tagged with "[job k] ", k counting from 0 in the order of the job list.
+ * @param[in] argc The number of arguments, as received by main.
+ * @param[in] argv The arguments, as received by main.
+ * @param[in] options The options of the command line.
+ * @return EXIT_SUCCESS if every job ran, EXIT_FAILURE otherwise; a job that fails does not stop the others.
+ **/
+static int run_batch(int argc, char* argv[], const struct options* options)
+{
+	const int MASTER_PROCESS_RANK = 0;
+	int my_rank;
+	MPI_Comm_rank(MPI_COMM_WORLD, &my_rank);
+	int comm_size;
+	MPI_Comm_size(MPI_COMM_WORLD, &comm_size);
+
+	struct batch batch;
+	if(batch_load(&batch, options->batch_path, MASTER_PROCESS_RANK, MPI_COMM_WORLD) != 0)
+	{
+		if(my_rank == MASTER_PROCESS_RANK)
+		{
+			fprintf(stderr, "Cannot read any job from \"%s\".\n", options->batch_path);
+		}
+		return EXIT_FAILURE;
+	}
+
+	// The master MPI process parses every job before any runs, so that a mistake in the job list is reported once and costs nothing
+	int invalid_job = -1;
 	if(my_rank == MASTER_PROCESS_RANK)
 	{
-		printf("The program took %.2f seconds in total and executed %d iterations.\n", total_time_so_far, iteration_count);
+		for(int k = 0; k < batch.count && invalid_job < 0; k++)
+		{
+			struct batch_job job;
+			struct options job_options;
+			if(batch_job_create(&job, batch.jobs[k], argc, argv) != 0 || parse_options(job.argc, job.argv, &job_options) != 0)
+			{
+				fprintf(stderr, "Job %d of \"%s\" is invalid: %s\n", k, options->batch_path, batch.jobs[k]);
+				invalid_job = k;
+			}
+			batch_job_destroy(&job);
+		}
+	}
+	MPI_Bcast(&invalid_job, 1, MPI_INT, MASTER_PROCESS_RANK, MPI_COMM_WORLD);
+	if(invalid_job >= 0)
+	{
+		batch_free(&batch);
+		return EXIT_FAILURE;
 	}
 
-	MPI_Finalize();
+	// There is no point in more groups than jobs or MPI processes
+	int groups = (options->groups > 0) ? options->groups : comm_size;
+	groups = (groups > comm_size) ? comm_size : groups;
+	groups = (groups > batch.count) ? batch.count : groups;
+	const int my_group = (int)((long long)my_rank * groups / comm_size);
+	MPI_Comm group_comm;
+	MPI_Comm_split(MPI_COMM_WORLD, my_group, my_rank, &group_comm);
+	int group_rank;
+	MPI_Comm_rank(group_comm, &group_rank);
+	int group_size;
+	MPI_Comm_size(group_comm, &group_size);
+
+	const double start_time = MPI_Wtime();
+	int my_status = EXIT_SUCCESS;
+	struct workspace workspace = {0};
+	for(int k = my_group; k < batch.count; k += groups)
+	{
+		char tag[32];
+		snprintf(tag, sizeof(tag), "[job %d] ", k);
+		output_tag = tag;
+
+		// The options of the job come after those of the command line, which are the defaults of every job
+		// A job that fails, whatever the reason, fails on every MPI process of its group, which carries on with its next job
+		struct batch_job job;
+		struct options job_options;
+		const int created = batch_job_create(&job, batch.jobs[k], argc, argv) == 0 && parse_options(job.argc, job.argv, &job_options) == 0;
+		if(!created)
+		{
+			fprintf(stderr, "%sCannot allocate the arguments of the job.\n", output_tag);
+		}
+		if(!all_succeeded(created, group_comm))
+		{
+			my_status = EXIT_FAILURE;
+		}
+		else
+		{
+			if(group_rank == MASTER_PROCESS_RANK)
+			{
+				printf("%sRunning on %d MPI processes with: %s\n", output_tag, group_size, batch.jobs[k]);
+			}
+			if(run_simulation(job_options, group_comm, &workspace) != EXIT_SUCCESS)
+			{
+				my_status = EXIT_FAILURE;
+			}
+		}
+		batch_job_destroy(&job);
+	}
+	output_tag = "";
+	workspace_release(&workspace);
+
+	// Every group waits for the others, so that the time of the batch is that of its slowest group
+	int status;
+	MPI_Allreduce(&my_status, &status, 1, MPI_INT, MPI_MAX, MPI_COMM_WORLD);
+	if(my_rank == MASTER_PROCESS_RANK)
+	{
+		printf("The batch of %d jobs took %.2f seconds in total on %d groups of MPI processes.\n", batch.count, MPI_Wtime() - start_time, groups);
+	}
+	MPI_Comm_free(&group_comm);
+	batch_free(&batch);
+	return status;
+}
+
+/// The longest request the service accepts, in characters.
+#define MAX_REQUEST_LENGTH 4096
+
+/**
+ * @brief Stays resident and runs the requests received on a Unix domain socket, see service.h.
+ * @details The master MPI process accepts the requests and broadcasts them; every run reuses the buffers of the last one when the plate has the same size, so that only the first run pays for their allocation and first touch. While a request runs, the standard output and error of the master MPI process are those of the client.
+ * @param[in] argc The number of arguments, as received by main.
+ * @param[in] argv The arguments, as received by main.
+ * @param[in] options The options of the command line, which are the defaults of every request.
+ * @return EXIT_SUCCESS once a client asks the service to quit, EXIT_FAILURE if the socket cannot be created.
+ **/
+static int run_service(int argc, char* argv[], const struct options* options)
+{
+	const int MASTER_PROCESS_RANK = 0;
+	int my_rank;
+	MPI_Comm_rank(MPI_COMM_WORLD, &my_rank);
+
+	int listener = -1;
+	if(my_rank == MASTER_PROCESS_RANK)
+	{
+		listener = service_listen(options->serve_path);
+		// A client that leaves before the end of its run must not take the service down with it
+		signal(SIGPIPE, SIG_IGN);
+	}
+	MPI_Bcast(&listener, 1, MPI_INT, MASTER_PROCESS_RANK, MPI_COMM_WORLD);
+	if(listener < 0)
+	{
+		return EXIT_FAILURE;
+	}
+	if(my_rank == MASTER_PROCESS_RANK)
+	{
+		printf("Serving on %s.\n", options->serve_path);
+		fflush(stdout);
+	}
 
+	// The buffers of the plate of the command line are allocated and faulted in now, so that the first request of that size does not pay for them
+	struct workspace workspace = {0};
+	if(workspace_prepare(&workspace, options, MPI_COMM_WORLD, MASTER_PROCESS_RANK) != 0 && my_rank == MASTER_PROCESS_RANK)
+	{
+		fprintf(stderr, "Cannot decompose a %dx%d plate across the MPI processes or allocate it; the first request will try again.\n", options->rows, options->columns);
+	}
+	char request[MAX_REQUEST_LENGTH];
+	for(int request_count = 0; ; request_count++)
+	{
+		// A length of -1 tells everybody to quit
+		int length = 0;
+		int client = -1;
+		int saved_stdout = -1;
+		int saved_stderr = -1;
+		if(my_rank == MASTER_PROCESS_RANK)
+		{
+			do
+			{
+				client = service_accept(listener, request, sizeof(request));
+			} while(client < 0);
+			length = (strcmp(request, "quit") == 0) ? -1 : (int)strlen(request) + 1;
+			printf("Request %d: %s\n", request_count, request);
+			fflush(stdout);
+			fflush(stderr);
+			saved_stdout = dup(STDOUT_FILENO);
+			saved_stderr = dup(STDERR_FILENO);
+			dup2(client, STDOUT_FILENO);
+			dup2(client, STDERR_FILENO);
+		}
+		MPI_Bcast(&length, 1, MPI_INT, MASTER_PROCESS_RANK, MPI_COMM_WORLD);
+		int valid = 0;
+		if(length > 0)
+		{
+			MPI_Bcast(request, length, MPI_CHAR, MASTER_PROCESS_RANK, MPI_COMM_WORLD);
+
+			// Like a job, a request is checked by the master MPI process alone so that its mistakes are reported once, to the client
+			struct batch_job job;
+			struct options job_options;
+			if(my_rank == MASTER_PROCESS_RANK)
+			{
+				valid = batch_job_create(&job, request, argc, argv) == 0 && parse_options(job.argc, job.argv, &job_options) == 0;
+				batch_job_destroy(&job);
+			}
+			MPI_Bcast(&valid, 1, MPI_INT, MASTER_PROCESS_RANK, MPI_COMM_WORLD);
+			if(valid)
+			{
+				// A run that fails, whatever the reason, fails on every MPI process and leaves the service waiting for the next request
+				const int created = batch_job_create(&job, request, argc, argv) == 0 && parse_options(job.argc, job.argv, &job_options) == 0;
+				valid = all_succeeded(created, MPI_COMM_WORLD) && run_simulation(job_options, MPI_COMM_WORLD, &workspace) == EXIT_SUCCESS;
+				batch_job_destroy(&job);
+			}
+		}
+
+		if(my_rank == MASTER_PROCESS_RANK)
+		{
+			if(length > 0)
+			{
+				printf("Request complete: %s.\n", valid ? "success" : "failure");
+			}
+			fflush(stdout);
+			fflush(stderr);
+			dup2(saved_stdout, STDOUT_FILENO);
+			dup2(saved_stderr, STDERR_FILENO);
+			close(saved_stdout);
+			close(saved_stderr);
+			close(client);
+		}
+		if(length < 0)
+		{
+			break;
+		}
+	}
+
+	workspace_release(&workspace);
+	if(my_rank == MASTER_PROCESS_RANK)
+	{
+		service_close(listener, options->serve_path);
+		printf("Service on %s stopped.\n", options->serve_path);
+	}
 	return EXIT_SUCCESS;
 }
+
+/**
+ * @argv[0] Name of the program
+ * @argv[1...] options, see options.h
+ **/
+int main(int argc, char* argv[])
+{
+	MPI_Init(NULL, NULL);
+
+	// Every MPI process reads the same command line so there is no need to broadcast the options
+	struct options options;
+	if(parse_options(argc, argv, &options) != 0)
+	{
+		MPI_Finalize();
+		return EXIT_FAILURE;
+	}
+
+	int status;
+	if(options.batch_path != NULL)
+	{
+		status = run_batch(argc, argv, &options);
+	}
+	else if(options.serve_path != NULL)
+	{
+		status = run_service(argc, argv, &options);
+	}
+	else
+	{
+		struct workspace workspace = {0};
+		status = run_simulation(options, MPI_COMM_WORLD, &workspace);
+		workspace_release(&workspace);
+	}
+
+	MPI_Finalize();
+
+	return status;
+}
@@ -0,0 +1,360 @@
+/**
+ * @file cpu3d.c
+ * @brief The 3D version: a block made of planes of rows and columns, with the 7-point stencil of heat3d.h.
+ * @details The block is decomposed into slabs of consecutive planes, one per MPI process, and iterated like the plate by cpu.c: exchange the ghost planes, propagate, swap the buffers, then every SNAPSHOT_INTERVAL iterations gather a snapshot of the block and print the maximum temperature change overall, and its hash with --hash. The sources are boxes of cells at MAX_TEMPERATURE, given with --source; without any, a cube in the middle of the block whose side is half its smallest dimension.
+ * Usage: mpirun -np N cpu3d_small [--planes N] [--rows N] [--columns N] [--source P0,R0,C0,P1,R1,C1]... [--iterations N] [--max-time S] [--tolerance T] [--tile-rows N] [--tile-columns N] [--hash]
+ **/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <getopt.h>
+#include <inttypes.h>
+#include <math.h>
+#include <mpi.h>
+#include <omp.h>
+
+#include "util.h"
+#include "options.h"
+#include "slab.h"
+#include "heat3d.h"
+#include "fingerprint.h"
+
+/// The number of planes, rows and columns of the block by default.
+#define BLOCK_SIDE 128
+
+/// The most sources a run can have.
+#define MAX_SOURCES 16
+
+/**
+ * @brief A box of sources: the cells between both corners, included.
+ **/
+struct source_box
+{
+	int first[3];
+	int last[3];
+};
+
+/**
+ * @brief Options controlling a 3D run.
+ **/
+struct block_options
+{
+	/// The number of planes, rows and columns of the block.
+	int planes;
+	int rows;
+	int columns;
+	/// The boxes of sources.
+	struct source_box sources[MAX_SOURCES];
+	/// The number of boxes of sources, 0 for the cube in the middle.
+	int source_count;
+	/// If strictly positive, the run stops after that many iterations.
+	int max_iterations;
+	/// If strictly positive, the run stops after that many seconds.
+	double max_time;
+	/// If strictly positive, the run stops as soon as the maximum temperature change falls below it.
+	double tolerance;
+	/// The number of rows and columns of a tile of the kernel, 0 to let heat3d_tiles choose.
+	int tile_rows;
+	int tile_columns;
+	/// Print the hash of the entire block after every snapshot.
+	int hash;
+};
+
+static void print_usage(const char* program_name)
+{
+	fprintf(stderr, "Usage: %s [OPTIONS]\n", program_name);
+	fprintf(stderr, "  --planes N          number of planes in the block (default %d)\n", BLOCK_SIDE);
+	fprintf(stderr, "  --rows N            number of rows in a plane (default %d)\n", BLOCK_SIDE);
+	fprintf(stderr, "  --columns N         number of columns in a plane (default %d)\n", BLOCK_SIDE);
+	fprintf(stderr, "  --source P0,R0,C0,P1,R1,C1  a box of sources between two corners, included; up to %d (default: a cube in the middle)\n", MAX_SOURCES);
+	fprintf(stderr, "  --iterations N      stop after N iterations instead of after MAX_TIME seconds\n");
+	fprintf(stderr, "  --max-time S        stop after S seconds (default: MAX_TIME unless --iterations or --tolerance is given)\n");
+	fprintf(stderr, "  --tolerance T       stop as soon as the maximum temperature change falls below T\n");
+	fprintf(stderr, "  --tile-rows N       number of rows in a tile of the kernel (default: chosen for a cache of %d KiB)\n", HEAT3D_TILE_BYTES / 1024);
+	fprintf(stderr, "  --tile-columns N    number of columns in a tile of the kernel (default: chosen likewise)\n");
+	fprintf(stderr, "  --hash              print the hash of the entire block after every snapshot\n");
+}
+
+/**
+ * @brief Fills the options from the command line.
+ * @return 0 on success, -1 if an option is not understood, in which case a usage message has been printed on stderr.
+ **/
+static int parse_block_options(int argc, char* argv[], struct block_options* options)
+{
+	static const struct option long_options[] =
+	{
+		{"planes",     required_argument, NULL, 'P'},
+		{"rows",       required_argument, NULL, 'r'},
+		{"columns",    required_argument, NULL, 'c'},
+		{"source",     required_argument, NULL, 'o'},
+		{"iterations", required_argument, NULL, 'i'},
+		{"max-time",   required_argument, NULL, 't'},
+		{"tolerance",  required_argument, NULL, 'T'},
+		{"tile-rows",  required_argument, NULL, 'R'},
+		{"tile-columns", required_argument, NULL, 'C'},
+		{"hash",       no_argument,       NULL, 'h'},
+		{NULL,         0,                 NULL, 0}
+	};
+
+	options->planes = BLOCK_SIDE;
+	options->rows = BLOCK_SIDE;
+	options->columns = BLOCK_SIDE;
+	options->source_count = 0;
+	options->max_iterations = 0;
+	options->max_time = 0.0;
+	options->tolerance = 0.0;
+	options->tile_rows = 0;
+	options->tile_columns = 0;
+	options->hash = 0;
+
+	opterr = 0;
+	int option;
+	while((option = getopt_long(argc, argv, "", long_options, NULL)) != -1)
+	{
+		int status = 0;
+		switch(option)
+		{
+			case 'P':
+				status = parse_positive_option("number of planes", optarg, &options->planes);
+				break;
+			case 'r':
+				status = parse_positive_option("number of rows", optarg, &options->rows);
+				break;
+			case 'c':
+				status = parse_columns_option(optarg, &options->columns);
+				break;
+			case 'o':
+			{
+				struct source_box* box = &options->sources[options->source_count];
+				int end = 0;
+				if(options->source_count == MAX_SOURCES || sscanf(optarg, "%d,%d,%d,%d,%d,%d%n", &box->first[0], &box->first[1], &box->first[2], &box->last[0], &box->last[1], &box->last[2], &end) != 6 || optarg[end] != '\0')
+				{
+					fprintf(stderr, "A source must be 6 integers separated by commas, at most %d of them, got '%s'.\n", MAX_SOURCES, optarg);
+					status = -1;
+				}
+				options->source_count++;
+				break;
+			}
+			case 'i':
+				status = parse_positive_option("number of iterations", optarg, &options->max_iterations);
+				break;
+			case 't':
+				status = parse_positive_real_option("maximum time", optarg, &options->max_time);
+				break;
+			case 'T':
+				status = parse_positive_real_option("tolerance", optarg, &options->tolerance);
+				break;
+			case 'R':
+				status = parse_positive_option("number of rows in a tile", optarg, &options->tile_rows);
+				break;
+			case 'C':
+				status = parse_positive_option("number of columns in a tile", optarg, &options->tile_columns);
+				break;
+			case 'h':
+				options->hash = 1;
+				break;
+			default:
+				status = report_unknown_option(argv);
+				break;
+		}
+		if(status != 0)
+		{
+			print_usage(argv[0]);
+			return -1;
+		}
+	}
+
+	if(check_no_operands(argc, argv) != 0)
+	{
+		print_usage(argv[0]);
+		return -1;
+	}
+	return 0;
+}
+
+/**
+ * @brief Initialises the block: the sources at MAX_TEMPERATURE, 0 elsewhere.
+ **/
+static void initialise_block(double* block, const struct block_options* options)
+{
+	const int sizes[3] = {options->planes, options->rows, options->columns};
+	struct source_box boxes[MAX_SOURCES];
+	int box_count = options->source_count;
+	memcpy(boxes, options->sources, sizeof(boxes));
+	if(box_count == 0)
+	{
+		int side = options->planes;
+		side = (options->rows < side) ? options->rows : side;
+		side = (options->columns < side) ? options->columns : side;
+		for(int axis = 0; axis < 3; axis++)
+		{
+			boxes[0].first[axis] = sizes[axis] / 2 - side / 4;
+			boxes[0].last[axis] = sizes[axis] / 2 + side / 4;
+		}
+		box_count = 1;
+	}
+
+	memset(block, 0, (size_t)options->planes * options->rows * options->columns * sizeof(double));
+	for(int b = 0; b < box_count; b++)
+	{
+		// Boxes may extend beyond the block, which clips them
+		int first[3];
+		int last[3];
+		for(int axis = 0; axis < 3; axis++)
+		{
+			first[axis] = (boxes[b].first[axis] < boxes[b].last[axis]) ? boxes[b].first[axis] : boxes[b].last[axis];
+			last[axis] = (boxes[b].first[axis] < boxes[b].last[axis]) ? boxes[b].last[axis] : boxes[b].first[axis];
+			first[axis] = (first[axis] < 0) ? 0 : first[axis];
+			last[axis] = (last[axis] >= sizes[axis]) ? sizes[axis] - 1 : last[axis];
+		}
+		for(int p = first[0]; p <= last[0]; p++)
+		{
+			for(int i = first[1]; i <= last[1]; i++)
+			{
+				for(int j = first[2]; j <= last[2]; j++)
+				{
+					block[((size_t)p * options->rows + i) * options->columns + j] = MAX_TEMPERATURE;
+				}
+			}
+		}
+	}
+}
+
+/**
+ * @argv[0] Name of the program
+ * @argv[1...] options, see print_usage
+ **/
+int main(int argc, char* argv[])
+{
+	MPI_Init(NULL, NULL);
+
+	const int MASTER_PROCESS_RANK = 0;
+	int my_rank;
+	MPI_Comm_rank(MPI_COMM_WORLD, &my_rank);
+
+	struct block_options options;
+	if(parse_block_options(argc, argv, &options) != 0)
+	{
+		MPI_Finalize();
+		return EXIT_FAILURE;
+	}
+	if(options.max_time == 0.0 && options.max_iterations == 0 && options.tolerance == 0.0)
+	{
+		options.max_time = MAX_TIME;
+	}
+
+	// A plane is a row of rows * columns cells for the slab, so the planes are decomposed and exchanged like the rows of the plate; the counts of the gather must fit in an int
+	const size_t plane_size = (size_t)options.rows * options.columns;
+	struct slab slab;
+	if(plane_size * options.planes > INT_MAX || slab_create(&slab, MPI_COMM_WORLD, options.planes, (int)plane_size) != 0)
+	{
+		if(my_rank == MASTER_PROCESS_RANK)
+		{
+			fprintf(stderr, "Cannot decompose a %dx%dx%d block across the MPI processes.\n", options.planes, options.rows, options.columns);
+		}
+		MPI_Finalize();
+		return EXIT_FAILURE;
+	}
+	int tile_rows;
+	int tile_columns;
+	heat3d_tiles(options.rows, options.columns, omp_get_max_threads(), &tile_rows, &tile_columns);
+	tile_rows = (options.tile_rows > 0) ? options.tile_rows : tile_rows;
+	tile_columns = (options.tile_columns > 0) ? options.tile_columns : tile_columns;
+
+	/// On master process only: the entire block, then the last snapshot made
+	double* block = NULL;
+	if(my_rank == MASTER_PROCESS_RANK)
+	{
+		block = malloc((size_t)options.planes * plane_size * sizeof(double));
+		if(block == NULL)
+		{
+			fprintf(stderr, "Cannot allocate the %dx%dx%d block.\n", options.planes, options.rows, options.columns);
+			MPI_Abort(MPI_COMM_WORLD, EXIT_FAILURE);
+		}
+		initialise_block(block, &options);
+	}
+
+	MPI_Barrier(MPI_COMM_WORLD);
+	double total_time_so_far = 0.0;
+	double start_time = MPI_Wtime();
+
+	// Each MPI process receives its planes in both buffers, the ghost planes stay at 0 until exchanged
+	slab_scatter(&slab, block, MASTER_PROCESS_RANK);
+	if(my_rank == MASTER_PROCESS_RANK)
+	{
+		printf("Data acquisition complete: %dx%dx%d block, tiles of %dx%d cells.\n", options.planes, options.rows, options.columns, tile_rows, tile_columns);
+	}
+
+	int iteration_count = 0;
+	/// Maximum temperature change observed across all MPI processes
+	double global_temperature_change;
+	/// Maximum temperature change for us
+	double my_temperature_change;
+	/// Set once the maximum temperature change overall has fallen below the tolerance
+	int converged = 0;
+	while(!converged && (options.max_iterations == 0 || iteration_count < options.max_iterations) && (options.max_time == 0.0 || total_time_so_far < options.max_time))
+	{
+		const int snapshot_iteration = iteration_count % SNAPSHOT_INTERVAL == 0;
+
+		slab_exchange_ghost_rows(&slab, slab.temperatures_last);
+		my_temperature_change = heat3d_propagate(slab.temperatures_last, slab.temperatures, slab.rows, options.rows, options.columns, tile_rows, tile_columns);
+		slab_swap(&slab);
+
+		// Start the gather of the snapshot, which completes while the maximum temperature change is reduced
+		MPI_Request gather_request;
+		if(snapshot_iteration)
+		{
+			MPI_Igatherv(&slab.temperatures_last[slab.columns], slab.rows * slab.columns, MPI_DOUBLE, block, slab.cell_counts, slab.cell_offsets, MPI_DOUBLE, MASTER_PROCESS_RANK, MPI_COMM_WORLD, &gather_request);
+		}
+		MPI_Allreduce(&my_temperature_change, &global_temperature_change, 1, MPI_DOUBLE, MPI_MAX, MPI_COMM_WORLD);
+
+		if(snapshot_iteration)
+		{
+			MPI_Wait(&gather_request, MPI_STATUS_IGNORE);
+			if(my_rank == MASTER_PROCESS_RANK)
+			{
+				printf("Iteration %d: %.18f\n", iteration_count, global_temperature_change);
+			}
+			if(options.hash)
+			{
+				uint64_t hash = fingerprint_field(&slab.temperatures_last[slab.columns], slab.rows, slab.columns, slab.first_global_row, MPI_COMM_WORLD, MASTER_PROCESS_RANK);
+				if(my_rank == MASTER_PROCESS_RANK)
+				{
+					printf("Hash %d: 0x%016" PRIx64 "\n", iteration_count, hash);
+				}
+			}
+		}
+
+		// Everybody has the same maximum temperature change overall, so everybody takes the same decision
+		converged = global_temperature_change < options.tolerance;
+		if(my_rank == MASTER_PROCESS_RANK)
+		{
+			total_time_so_far = MPI_Wtime() - start_time;
+		}
+		MPI_Bcast(&total_time_so_far, 1, MPI_DOUBLE, MASTER_PROCESS_RANK, MPI_COMM_WORLD);
+
+		iteration_count++;
+	}
+
+	if(my_rank == MASTER_PROCESS_RANK)
+	{
+		printf("The program took %.2f seconds in total and executed %d iterations, %.0f cell updates per second.\n", total_time_so_far, iteration_count, (double)iteration_count * options.planes * plane_size / total_time_so_far);
+		if(converged)
+		{
+			printf("Converged below %g after %d iterations, time to solution %.6f seconds, last maximum temperature change %.18f.\n", options.tolerance, iteration_count, total_time_so_far, global_temperature_change);
+		}
+		else if(options.tolerance > 0.0)
+		{
+			printf("Did not converge below %g, last maximum temperature change %.18f.\n", options.tolerance, global_temperature_change);
+		}
+	}
+
+	free(block);
+	slab_destroy(&slab);
+
+	MPI_Finalize();
+
+	return EXIT_SUCCESS;
+}
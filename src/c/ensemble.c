@@ -0,0 +1,107 @@
+/**
+ * @file ensemble.c
+ * @brief Ensembles of plates stored interleaved.
+ **/
+
+#include <stddef.h>
+#include <math.h>
+#include <omp.h>
+
+#include "ensemble.h"
+
+double ensemble_propagate(const double* restrict temperatures_last, double* restrict temperatures, int rows, int columns, int members, double* restrict changes, double* restrict thread_changes)
+{
+	for(int m = 0; m < members; m++)
+	{
+		changes[m] = 0.0;
+	}
+
+	const size_t row_length = (size_t)columns * members;
+	#pragma omp parallel
+	{
+		// Each thread keeps the changes of its rows, merged once at the end
+		double* restrict my_changes = &thread_changes[(size_t)omp_get_thread_num() * members];
+		for(int m = 0; m < members; m++)
+		{
+			my_changes[m] = 0.0;
+		}
+
+		#pragma omp for
+		for(int i = 1; i <= rows; i++)
+		{
+			const double* restrict before = &temperatures_last[(i - 1) * row_length];
+			const double* restrict last = &temperatures_last[i * row_length];
+			const double* restrict after = &temperatures_last[(i + 1) * row_length];
+			double* restrict current = &temperatures[i * row_length];
+
+			// The first column, which has no neighbour on its left
+			#pragma omp simd
+			for(int m = 0; m < members; m++)
+			{
+				current[m] = (last[m] == MAX_TEMPERATURE) ? MAX_TEMPERATURE : (before[m] + after[m] + last[members + m]) / 3.0;
+				my_changes[m] = fmax(fabs(current[m] - last[m]), my_changes[m]);
+			}
+
+			// The columns in between, neighbours summed in the order of heat_propagate
+			for(int j = 1; j < columns - 1; j++)
+			{
+				const size_t cell = (size_t)j * members;
+				#pragma omp simd
+				for(int m = 0; m < members; m++)
+				{
+					const double sum = before[cell + m] + after[cell + m] + last[cell - members + m] + last[cell + members + m];
+					current[cell + m] = (last[cell + m] == MAX_TEMPERATURE) ? MAX_TEMPERATURE : 0.25 * sum;
+					my_changes[m] = fmax(fabs(current[cell + m] - last[cell + m]), my_changes[m]);
+				}
+			}
+
+			// The last column, which has no neighbour on its right
+			const size_t end = (size_t)(columns - 1) * members;
+			#pragma omp simd
+			for(int m = 0; m < members; m++)
+			{
+				current[end + m] = (last[end + m] == MAX_TEMPERATURE) ? MAX_TEMPERATURE : (before[end + m] + after[end + m] + last[end - members + m]) / 3.0;
+				my_changes[m] = fmax(fabs(current[end + m] - last[end + m]), my_changes[m]);
+			}
+		}
+
+		#pragma omp critical
+		for(int m = 0; m < members; m++)
+		{
+			changes[m] = fmax(my_changes[m], changes[m]);
+		}
+	}
+
+	double temperature_change = 0.0;
+	for(int m = 0; m < members; m++)
+	{
+		temperature_change = fmax(changes[m], temperature_change);
+	}
+	return temperature_change;
+}
+
+void ensemble_store(const double* plate, double* ensemble, int rows, int columns, int members, int member)
+{
+	#pragma omp parallel for
+	for(int i = 0; i < rows; i++)
+	{
+		double* row = &ensemble[(size_t)(i + 1) * columns * members];
+		for(int j = 0; j < columns; j++)
+		{
+			row[(size_t)j * members + member] = plate[(size_t)i * columns + j];
+		}
+	}
+}
+
+void ensemble_load(const double* ensemble, double* plate, int rows, int columns, int members, int member)
+{
+	#pragma omp parallel for
+	for(int i = 0; i < rows; i++)
+	{
+		const double* row = &ensemble[(size_t)(i + 1) * columns * members];
+		for(int j = 0; j < columns; j++)
+		{
+			plate[(size_t)i * columns + j] = row[(size_t)j * members + member];
+		}
+	}
+}
@@ -0,0 +1,39 @@
+/**
+ * @file ensemble.h
+ * @brief Ensembles of plates stored interleaved, so that the Jacobi iteration advances every member of the ensemble with one SIMD lane each.
+ * @details The cells of all members at the same position are contiguous: cell (i, j) of member m is at ((i * columns) + j) * members + m. Like a slab, an ensemble is preceded and followed by one ghost row, at 0, and its rows are numbered from the ghost row before it. Every member follows the rules of heat_propagate, in the same order, so each member ends up bit for bit where a run of its own plate would.
+ **/
+
+#ifndef ENSEMBLE_H_INCLUDED
+#define ENSEMBLE_H_INCLUDED
+
+/**
+ * @brief Propagates the temperatures of every member of an ensemble by one iteration and calculates the maximum temperature change of each.
+ * @param[in] temperatures_last The temperatures at the previous iteration, ghost rows included.
+ * @param[out] temperatures The temperatures at this iteration; ghost rows are not written.
+ * @param[in] rows The number of rows of every member, ghost rows excluded.
+ * @param[in] columns The number of columns of every member, at least 2.
+ * @param[in] members The number of members.
+ * @param[out] changes The maximum absolute temperature change of every member.
+ * @param[out] thread_changes Room for the changes every OpenMP thread keeps of its own rows, omp_get_max_threads() * members; on the heap, since an ensemble can have more members than a thread's stack can hold.
+ * @return The maximum absolute temperature change across members.
+ **/
+double ensemble_propagate(const double* restrict temperatures_last, double* restrict temperatures, int rows, int columns, int members, double* restrict changes, double* restrict thread_changes);
+
+/**
+ * @brief Copies a plate into one member of an ensemble.
+ * @param[in] plate The plate, rows * columns in row-major order.
+ * @param[out] ensemble The ensemble, ghost rows included; the ghost rows are not written.
+ * @param[in] member The member to write.
+ **/
+void ensemble_store(const double* plate, double* ensemble, int rows, int columns, int members, int member);
+
+/**
+ * @brief Copies one member of an ensemble into a plate.
+ * @param[in] ensemble The ensemble, ghost rows included.
+ * @param[out] plate The plate, rows * columns in row-major order.
+ * @param[in] member The member to read.
+ **/
+void ensemble_load(const double* ensemble, double* plate, int rows, int columns, int members, int member);
+
+#endif
@@ -0,0 +1,342 @@
+/**
+ * @file ensemble_cpu.c
+ * @brief Runs an ensemble of plates that differ only in their sources, for parameter sweeps.
+ * @details Member m has a source on every row at the columns j such that j % PERIOD == (m * SHIFT) % PERIOD; with the default period of 100, member 0 is the small dataset. The members are split across the MPI processes, each holding whole plates and iterating them on its own, interleaved so that one SIMD lane advances each member, see ensemble.h. Without a tolerance, every member runs the same iterations; with one, each member reports the iteration at which it converged, and an MPI process stops once all of its members have.
+ * Usage: mpirun -np N ensemble_small [--members N] [--period P] [--shift S] [--rows N] [--columns N] [--iterations N] [--max-time S] [--tolerance T] [--hash]
+ **/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <getopt.h>
+#include <inttypes.h>
+#include <math.h>
+#include <mpi.h>
+#include <omp.h>
+
+#include "util.h"
+#include "options.h"
+#include "ensemble.h"
+#include "fingerprint.h"
+
+/**
+ * @brief Options controlling an ensemble run.
+ **/
+struct ensemble_options
+{
+	/// The number of members.
+	int members;
+	/// The distance between two source columns.
+	int period;
+	/// The distance between the first source columns of two consecutive members.
+	int shift;
+	/// The number of rows of every member.
+	int rows;
+	/// The number of columns of every member.
+	int columns;
+	/// If strictly positive, the run stops after that many iterations.
+	int max_iterations;
+	/// If strictly positive, the run stops after that many seconds.
+	double max_time;
+	/// If strictly positive, every member converges once its maximum temperature change falls below it.
+	double tolerance;
+	/// Print the hash of every member at the end of the run.
+	int hash;
+};
+
+static void print_usage(const char* program_name)
+{
+	fprintf(stderr, "Usage: %s [OPTIONS]\n", program_name);
+	fprintf(stderr, "  --members N         number of plates in the ensemble (default 64)\n");
+	fprintf(stderr, "  --period P          distance between two source columns (default 100)\n");
+	fprintf(stderr, "  --shift S           distance between the first source columns of two consecutive members (default 1)\n");
+	fprintf(stderr, "  --rows N            number of rows in every plate (default %d)\n", ROWS);
+	fprintf(stderr, "  --columns N         number of columns in every plate (default %d)\n", COLUMNS);
+	fprintf(stderr, "  --iterations N      stop after N iterations\n");
+	fprintf(stderr, "  --max-time S        stop after S seconds (default: MAX_TIME unless --iterations or --tolerance is given)\n");
+	fprintf(stderr, "  --tolerance T       every member converges as soon as its maximum temperature change falls below T\n");
+	fprintf(stderr, "  --hash              print the hash of every member at the end of the run\n");
+}
+
+/**
+ * @brief Fills the options from the command line.
+ * @return 0 on success, -1 if an option is not understood, in which case a usage message has been printed on stderr.
+ **/
+static int parse_ensemble_options(int argc, char* argv[], struct ensemble_options* options)
+{
+	static const struct option long_options[] =
+	{
+		{"members",    required_argument, NULL, 'm'},
+		{"period",     required_argument, NULL, 'p'},
+		{"shift",      required_argument, NULL, 's'},
+		{"rows",       required_argument, NULL, 'r'},
+		{"columns",    required_argument, NULL, 'c'},
+		{"iterations", required_argument, NULL, 'i'},
+		{"max-time",   required_argument, NULL, 't'},
+		{"tolerance",  required_argument, NULL, 'T'},
+		{"hash",       no_argument,       NULL, 'h'},
+		{NULL,         0,                 NULL, 0}
+	};
+
+	options->members = 64;
+	options->period = 100;
+	options->shift = 1;
+	options->rows = ROWS;
+	options->columns = COLUMNS;
+	options->max_iterations = 0;
+	options->max_time = 0.0;
+	options->tolerance = 0.0;
+	options->hash = 0;
+
+	opterr = 0;
+	int option;
+	while((option = getopt_long(argc, argv, "", long_options, NULL)) != -1)
+	{
+		int status = 0;
+		switch(option)
+		{
+			case 'm':
+				status = parse_positive_option("number of members", optarg, &options->members);
+				break;
+			case 'p':
+				status = parse_positive_option("period", optarg, &options->period);
+				break;
+			case 's':
+				options->shift = atoi(optarg);
+				break;
+			case 'r':
+				status = parse_positive_option("number of rows", optarg, &options->rows);
+				break;
+			case 'c':
+				status = parse_columns_option(optarg, &options->columns);
+				break;
+			case 'i':
+				status = parse_positive_option("number of iterations", optarg, &options->max_iterations);
+				break;
+			case 't':
+				status = parse_positive_real_option("maximum time", optarg, &options->max_time);
+				break;
+			case 'T':
+				status = parse_positive_real_option("tolerance", optarg, &options->tolerance);
+				break;
+			case 'h':
+				options->hash = 1;
+				break;
+			default:
+				status = report_unknown_option(argv);
+				break;
+		}
+		if(status != 0)
+		{
+			print_usage(argv[0]);
+			return -1;
+		}
+	}
+
+	if(check_no_operands(argc, argv) != 0)
+	{
+		print_usage(argv[0]);
+		return -1;
+	}
+	return 0;
+}
+
+/**
+ * @brief Returns the first source column of a member, in [0, period[.
+ **/
+static int first_source_column(const struct ensemble_options* options, int member)
+{
+	const int offset = (int)(((long long)member * options->shift) % options->period);
+	return (offset < 0) ? offset + options->period : offset;
+}
+
+/**
+ * @brief Initialises the plate of a member: the sources on every row, 0 elsewhere.
+ **/
+static void initialise_member(double* plate, const struct ensemble_options* options, int member)
+{
+	const int first_column = first_source_column(options, member);
+	for(int i = 0; i < options->rows; i++)
+	{
+		for(int j = 0; j < options->columns; j++)
+		{
+			plate[(size_t)i * options->columns + j] = (j % options->period == first_column) ? MAX_TEMPERATURE : 0.0;
+		}
+	}
+}
+
+/**
+ * @argv[0] Name of the program
+ * @argv[1...] options, see print_usage
+ **/
+int main(int argc, char* argv[])
+{
+	MPI_Init(NULL, NULL);
+
+	const int MASTER_PROCESS_RANK = 0;
+	int my_rank;
+	MPI_Comm_rank(MPI_COMM_WORLD, &my_rank);
+	int comm_size;
+	MPI_Comm_size(MPI_COMM_WORLD, &comm_size);
+
+	struct ensemble_options options;
+	if(parse_ensemble_options(argc, argv, &options) != 0)
+	{
+		MPI_Finalize();
+		return EXIT_FAILURE;
+	}
+	if(options.max_time == 0.0 && options.max_iterations == 0 && options.tolerance == 0.0)
+	{
+		options.max_time = MAX_TIME;
+	}
+
+	// The members are split across the MPI processes like rows are across a slab: the first ones get one more if they do not divide evenly
+	int member_counts[comm_size];
+	int member_offsets[comm_size];
+	for(int rank = 0, offset = 0; rank < comm_size; rank++)
+	{
+		member_counts[rank] = options.members / comm_size + (rank < options.members % comm_size);
+		member_offsets[rank] = offset;
+		offset += member_counts[rank];
+	}
+	const int members = member_counts[my_rank];
+	const int first_member = member_offsets[my_rank];
+
+	// Every MPI process builds its own members; ghost rows stay at 0
+	const size_t ensemble_size = (size_t)(options.rows + 2) * options.columns * members;
+	double* temperatures_last = calloc(ensemble_size, sizeof(double));
+	double* temperatures = calloc(ensemble_size, sizeof(double));
+	double* plate = malloc((size_t)options.rows * options.columns * sizeof(double));
+	// Every array per member lives on the heap: a large ensemble would overflow the stack
+	const size_t member_slots = (size_t)members + 1;
+	double* changes = malloc(member_slots * sizeof(double));
+	double* thread_changes = malloc((size_t)omp_get_max_threads() * member_slots * sizeof(double));
+	/// The iterations each member ran before converging, or in total if it did not
+	int* member_iterations = malloc(member_slots * sizeof(int));
+	/// The maximum temperature change of each member at its last iteration counted
+	double* member_changes = malloc(member_slots * sizeof(double));
+	uint64_t* member_hashes = malloc(member_slots * sizeof(uint64_t));
+	/// Tells which members have converged
+	unsigned char* member_converged = malloc(member_slots);
+	if((members > 0 && (temperatures_last == NULL || temperatures == NULL)) || plate == NULL || changes == NULL || thread_changes == NULL ||
+	   member_iterations == NULL || member_changes == NULL || member_hashes == NULL || member_converged == NULL)
+	{
+		fprintf(stderr, "Cannot allocate %d members of %dx%d.\n", members, options.rows, options.columns);
+		MPI_Abort(MPI_COMM_WORLD, EXIT_FAILURE);
+	}
+	for(int m = 0; m < members; m++)
+	{
+		initialise_member(plate, &options, first_member + m);
+		ensemble_store(plate, temperatures_last, options.rows, options.columns, members, m);
+		ensemble_store(plate, temperatures, options.rows, options.columns, members, m);
+		member_iterations[m] = 0;
+		member_changes[m] = 0.0;
+		member_converged[m] = 0;
+	}
+
+	MPI_Barrier(MPI_COMM_WORLD);
+	const double start_time = MPI_Wtime();
+
+	// No member depends on another, so every MPI process iterates on its own until its members are done
+	int converged_members = 0;
+	int iteration_count = 0;
+	double time_so_far = 0.0;
+	while(members > 0 && converged_members < members && (options.max_iterations == 0 || iteration_count < options.max_iterations) && (options.max_time == 0.0 || time_so_far < options.max_time))
+	{
+		ensemble_propagate(temperatures_last, temperatures, options.rows, options.columns, members, changes, thread_changes);
+		double* swap = temperatures_last;
+		temperatures_last = temperatures;
+		temperatures = swap;
+		iteration_count++;
+
+		// A converged member keeps its lane, but its record stops at the iteration it converged
+		for(int m = 0; m < members; m++)
+		{
+			if(!member_converged[m])
+			{
+				member_iterations[m] = iteration_count;
+				member_changes[m] = changes[m];
+				if(options.tolerance > 0.0 && changes[m] < options.tolerance)
+				{
+					member_converged[m] = 1;
+					converged_members++;
+				}
+			}
+		}
+
+		if(iteration_count % SNAPSHOT_INTERVAL == 0)
+		{
+			time_so_far = MPI_Wtime() - start_time;
+		}
+	}
+	time_so_far = MPI_Wtime() - start_time;
+
+	if(options.hash)
+	{
+		for(int m = 0; m < members; m++)
+		{
+			ensemble_load(temperatures_last, plate, options.rows, options.columns, members, m);
+			member_hashes[m] = fingerprint_rows(plate, options.rows, options.columns, 0);
+		}
+	}
+
+	// The master MPI process reports every member, in order
+	int* all_iterations = NULL;
+	double* all_changes = NULL;
+	uint64_t* all_hashes = NULL;
+	if(my_rank == MASTER_PROCESS_RANK)
+	{
+		all_iterations = malloc((size_t)options.members * sizeof(int));
+		all_changes = malloc((size_t)options.members * sizeof(double));
+		all_hashes = malloc((size_t)options.members * sizeof(uint64_t));
+		if(all_iterations == NULL || all_changes == NULL || all_hashes == NULL)
+		{
+			fprintf(stderr, "Cannot allocate the report of %d members.\n", options.members);
+			MPI_Abort(MPI_COMM_WORLD, EXIT_FAILURE);
+		}
+	}
+	MPI_Gatherv(member_iterations, members, MPI_INT, all_iterations, member_counts, member_offsets, MPI_INT, MASTER_PROCESS_RANK, MPI_COMM_WORLD);
+	MPI_Gatherv(member_changes, members, MPI_DOUBLE, all_changes, member_counts, member_offsets, MPI_DOUBLE, MASTER_PROCESS_RANK, MPI_COMM_WORLD);
+	MPI_Gatherv(member_hashes, members, MPI_UINT64_T, all_hashes, member_counts, member_offsets, MPI_UINT64_T, MASTER_PROCESS_RANK, MPI_COMM_WORLD);
+	double slowest_time;
+	MPI_Reduce(&time_so_far, &slowest_time, 1, MPI_DOUBLE, MPI_MAX, MASTER_PROCESS_RANK, MPI_COMM_WORLD);
+	// Converged members still occupy their lane, so they count in the throughput
+	const long long my_member_iterations = (long long)iteration_count * members;
+	long long member_iterations_overall;
+	MPI_Reduce(&my_member_iterations, &member_iterations_overall, 1, MPI_LONG_LONG, MPI_SUM, MASTER_PROCESS_RANK, MPI_COMM_WORLD);
+
+	if(my_rank == MASTER_PROCESS_RANK)
+	{
+		for(int m = 0; m < options.members; m++)
+		{
+			printf("Member %d: sources every %d columns from column %d, %d iterations, last maximum temperature change %.18f", m, options.period, first_source_column(&options, m), all_iterations[m], all_changes[m]);
+			if(options.tolerance > 0.0)
+			{
+				printf(all_changes[m] < options.tolerance ? ", converged" : ", did not converge");
+			}
+			if(options.hash)
+			{
+				printf(", hash 0x%016" PRIx64, all_hashes[m]);
+			}
+			printf(".\n");
+		}
+		printf("The ensemble of %d members took %.2f seconds in total, %.0f cell updates per second.\n", options.members, slowest_time, (double)member_iterations_overall * options.rows * options.columns / slowest_time);
+	}
+
+	free(all_iterations);
+	free(all_changes);
+	free(all_hashes);
+	free(changes);
+	free(thread_changes);
+	free(member_iterations);
+	free(member_changes);
+	free(member_hashes);
+	free(member_converged);
+	free(temperatures_last);
+	free(temperatures);
+	free(plate);
+
+	MPI_Finalize();
+
+	return EXIT_SUCCESS;
+}
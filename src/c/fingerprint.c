@@ -0,0 +1,79 @@
+/**
+ * @file fingerprint.c
+ * @brief Hashing and dumping of the entire temperature field.
+ **/
+
+#include <string.h>
+#include <mpi.h>
+
+#include "fingerprint.h"
+
+/**
+ * @brief Finaliser of the SplitMix64 generator, which spreads every input bit across the whole output.
+ **/
+static inline uint64_t mix(uint64_t x)
+{
+	x ^= x >> 30;
+	x *= 0xBF58476D1CE4E5B9ULL;
+	x ^= x >> 27;
+	x *= 0x94D049BB133111EBULL;
+	x ^= x >> 31;
+	return x;
+}
+
+uint64_t fingerprint_rows(const double* temperatures, int rows, int columns, int first_global_row)
+{
+	uint64_t hash = 0;
+	#pragma omp parallel for reduction(+:hash)
+	for(int i = 0; i < rows; i++)
+	{
+		const uint64_t row_key = (uint64_t)(first_global_row + i) << 32;
+		for(int j = 0; j < columns; j++)
+		{
+			uint64_t bits;
+			memcpy(&bits, &temperatures[(size_t)i * columns + j], sizeof(bits));
+			hash += mix((row_key | (uint32_t)j) ^ mix(bits));
+		}
+	}
+	return hash;
+}
+
+uint64_t fingerprint_field(const double* temperatures, int rows, int columns, int first_global_row, MPI_Comm comm, int root)
+{
+	uint64_t my_hash = fingerprint_rows(temperatures, rows, columns, first_global_row);
+	uint64_t hash = 0;
+	MPI_Reduce(&my_hash, &hash, 1, MPI_UINT64_T, MPI_SUM, root, comm);
+	return hash;
+}
+
+int fingerprint_write_field(const char* path, const double* temperatures, int rows, int columns, int first_global_row, int total_rows, int iteration, MPI_Comm comm)
+{
+	MPI_File file;
+	int error = MPI_File_open(comm, path, MPI_MODE_CREATE | MPI_MODE_WRONLY, MPI_INFO_NULL, &file);
+	if(error != MPI_SUCCESS)
+	{
+		return error;
+	}
+	// Remove what a previous, possibly bigger, field left in the file
+	MPI_File_set_size(file, 0);
+
+	int my_rank;
+	MPI_Comm_rank(comm, &my_rank);
+	if(my_rank == 0)
+	{
+		struct fingerprint_field_header header = {FINGERPRINT_FIELD_MAGIC, total_rows, columns, iteration};
+		MPI_File_write_at(file, 0, &header, sizeof(header), MPI_BYTE, MPI_STATUS_IGNORE);
+	}
+
+	// Rows are written in chunks so that the count always fits in an int, whatever the size of the field
+	const MPI_Offset rows_per_write = (1 << 28) / columns > 0 ? (1 << 28) / columns : 1;
+	MPI_Offset my_offset = sizeof(struct fingerprint_field_header) + (MPI_Offset)first_global_row * columns * sizeof(double);
+	for(MPI_Offset row = 0; row < rows && error == MPI_SUCCESS; row += rows_per_write)
+	{
+		int count = (int)((rows - row < rows_per_write ? rows - row : rows_per_write) * columns);
+		error = MPI_File_write_at(file, my_offset + row * columns * sizeof(double), &temperatures[row * columns], count, MPI_DOUBLE, MPI_STATUS_IGNORE);
+	}
+
+	int close_error = MPI_File_close(&file);
+	return error != MPI_SUCCESS ? error : close_error;
+}
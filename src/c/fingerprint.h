@@ -0,0 +1,61 @@
+/**
+ * @file fingerprint.h
+ * @brief Hashing and dumping of the entire temperature field, used to verify that two runs computed exactly the same thing.
+ * @details The hash of a field is the sum, modulo 2^64, of a hash of every cell made from its global position and the bits of its value. Each MPI process hashes its own rows in parallel and the partial hashes are summed across MPI processes; because the sum is commutative, the hash does not depend on the decomposition, the number of OpenMP threads or the order in which the partial hashes arrive.
+ **/
+
+#ifndef FINGERPRINT_H_INCLUDED
+#define FINGERPRINT_H_INCLUDED
+
+#include <stdint.h>
+#include <mpi.h>
+
+/// Magic number at the beginning of every field file.
+#define FINGERPRINT_FIELD_MAGIC 0x444C454953534348ULL
+
+/**
+ * @brief Header of the binary files written by fingerprint_write_field, followed by rows * columns doubles in row-major order.
+ **/
+struct fingerprint_field_header
+{
+	/// Always FINGERPRINT_FIELD_MAGIC.
+	uint64_t magic;
+	/// Number of rows in the entire field.
+	int64_t rows;
+	/// Number of columns in the entire field.
+	int64_t columns;
+	/// Number of iterations executed when the field was written.
+	int64_t iteration;
+};
+
+/**
+ * @brief Hashes the rows held by this MPI process.
+ * @param[in] temperatures The first row to hash, followed by the others contiguously.
+ * @param[in] rows The number of rows to hash.
+ * @param[in] columns The number of columns in each row.
+ * @param[in] first_global_row The index of the first row in the entire field.
+ * @return The partial hash of these rows.
+ **/
+uint64_t fingerprint_rows(const double* temperatures, int rows, int columns, int first_global_row);
+
+/**
+ * @brief Hashes the entire field, distributed across the MPI processes of a communicator.
+ * @details This is a collective operation; the parameters are the same as fingerprint_rows.
+ * @param[in] comm The communicator across which the field is distributed.
+ * @param[in] root The rank of the MPI process receiving the hash.
+ * @return The hash of the entire field on the root MPI process, unspecified elsewhere.
+ **/
+uint64_t fingerprint_field(const double* temperatures, int rows, int columns, int first_global_row, MPI_Comm comm, int root);
+
+/**
+ * @brief Writes the entire field to a file using MPI-IO, each MPI process writing its own rows.
+ * @details This is a collective operation. The parameters are the same as fingerprint_rows, plus the following.
+ * @param[in] path The path of the file to write.
+ * @param[in] total_rows The number of rows in the entire field.
+ * @param[in] iteration The number of iterations executed, recorded in the header.
+ * @param[in] comm The communicator across which the field is distributed.
+ * @return MPI_SUCCESS on success, an MPI error code otherwise.
+ **/
+int fingerprint_write_field(const char* path, const double* temperatures, int rows, int columns, int first_global_row, int total_rows, int iteration, MPI_Comm comm);
+
+#endif
@@ -0,0 +1,241 @@
+/**
+ * @file geometry.c
+ * @brief Plates that are not rectangles: holes and cut-outs.
+ **/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include "geometry.h"
+#include "sources.h"
+
+int geometry_build(struct geometry* geometry, const unsigned char* metal, int rows, int columns)
+{
+	memset(geometry, 0, sizeof(*geometry));
+	geometry->rows = rows;
+	geometry->run_offsets = malloc((rows + 1) * sizeof(int));
+	geometry->cell_offsets = malloc((rows + 1) * sizeof(int));
+	geometry->metal = malloc((size_t)rows * columns);
+	if(geometry->run_offsets == NULL || geometry->cell_offsets == NULL || geometry->metal == NULL)
+	{
+		geometry_destroy(geometry);
+		return -1;
+	}
+	memcpy(geometry->metal, &metal[columns], (size_t)rows * columns);
+
+	// The runs and cells are counted in a first pass, then stored in a second one
+	for(int pass = 0; pass < 2; pass++)
+	{
+		int run_count = 0;
+		int cell_count = 0;
+		for(int i = 1; i <= rows; i++)
+		{
+			const unsigned char* above = &metal[(size_t)(i - 1) * columns];
+			const unsigned char* row = &metal[(size_t)i * columns];
+			const unsigned char* below = &metal[(size_t)(i + 1) * columns];
+			geometry->run_offsets[i - 1] = run_count;
+			geometry->cell_offsets[i - 1] = cell_count;
+			int run_begin = -1;
+			for(int j = 0; j <= columns; j++)
+			{
+				int neighbours = 0;
+				if(j < columns && row[j])
+				{
+					neighbours = (above[j] ? GEOMETRY_UP : 0) | (below[j] ? GEOMETRY_DOWN : 0) | ((j > 0 && row[j - 1]) ? GEOMETRY_LEFT : 0) | ((j < columns - 1 && row[j + 1]) ? GEOMETRY_RIGHT : 0);
+				}
+				const int full = j < columns && row[j] && neighbours == (GEOMETRY_UP | GEOMETRY_DOWN | GEOMETRY_LEFT | GEOMETRY_RIGHT);
+
+				// A run ends at the first cell that does not have all its neighbours
+				if(full && run_begin < 0)
+				{
+					run_begin = j;
+				}
+				else if(!full && run_begin >= 0)
+				{
+					if(pass == 1)
+					{
+						geometry->runs[run_count].begin = run_begin;
+						geometry->runs[run_count].end = j;
+					}
+					run_count++;
+					run_begin = -1;
+				}
+				if(j < columns && row[j] && !full)
+				{
+					if(pass == 1)
+					{
+						geometry->cells[cell_count].column = j;
+						geometry->cells[cell_count].neighbours = neighbours;
+					}
+					cell_count++;
+				}
+				if(pass == 1 && j < columns && row[j])
+				{
+					geometry->metal_cells++;
+				}
+			}
+		}
+		geometry->run_offsets[rows] = run_count;
+		geometry->cell_offsets[rows] = cell_count;
+		if(pass == 0)
+		{
+			geometry->runs = malloc((run_count > 0 ? run_count : 1) * sizeof(struct geometry_run));
+			geometry->cells = malloc((cell_count > 0 ? cell_count : 1) * sizeof(struct geometry_cell));
+			if(geometry->runs == NULL || geometry->cells == NULL)
+			{
+				geometry_destroy(geometry);
+				return -1;
+			}
+		}
+	}
+	return 0;
+}
+
+int geometry_create(struct geometry* geometry, const struct slab* slab, const char* path)
+{
+	memset(geometry, 0, sizeof(*geometry));
+	struct sources shapes;
+	if(sources_load(&shapes, path) != 0)
+	{
+		return -1;
+	}
+	int valid = !sources_scheduled(&shapes);
+	for(int s = 0; s < shapes.count; s++)
+	{
+		valid = valid && (shapes.list[s].temperature == 0.0 || shapes.list[s].temperature == 1.0);
+	}
+	if(!valid)
+	{
+		if(slab->my_rank == 0)
+		{
+			fprintf(stderr, "The shapes of \"%s\" must be 0, to cut the plate out, or 1, to put metal back, and cannot follow a schedule.\n", path);
+		}
+		sources_free(&shapes);
+		return -1;
+	}
+
+	// The rows around the slab are compiled too, those beyond the edges of the plate stay metal
+	const int columns = slab->columns;
+	const int first_row = (slab->first_global_row > 0) ? slab->first_global_row - 1 : 0;
+	const int end_row = (slab->first_global_row + slab->rows < slab->total_rows) ? slab->first_global_row + slab->rows + 1 : slab->total_rows;
+	const size_t cells = (size_t)(slab->rows + 2) * columns;
+	double* map = malloc(cells * sizeof(double));
+	unsigned char* metal = malloc(cells);
+	struct source_spans spans;
+	if(map == NULL || metal == NULL || sources_compile(&shapes, &spans, first_row, end_row - first_row, columns, 0) != 0)
+	{
+		fprintf(stderr, "Cannot allocate the geometry.\n");
+		free(map);
+		free(metal);
+		sources_free(&shapes);
+		return -1;
+	}
+	for(size_t k = 0; k < cells; k++)
+	{
+		map[k] = 1.0;
+	}
+	sources_paint(&spans, &map[(size_t)(first_row - (slab->first_global_row - 1)) * columns], columns);
+	for(size_t k = 0; k < cells; k++)
+	{
+		metal[k] = map[k] != 0.0;
+	}
+	const int status = geometry_build(geometry, metal, slab->rows, columns);
+	if(status != 0)
+	{
+		fprintf(stderr, "Cannot allocate the geometry.\n");
+	}
+
+	sources_spans_free(&spans);
+	sources_free(&shapes);
+	free(map);
+	free(metal);
+	return status;
+}
+
+void geometry_destroy(struct geometry* geometry)
+{
+	free(geometry->run_offsets);
+	free(geometry->runs);
+	free(geometry->cell_offsets);
+	free(geometry->cells);
+	free(geometry->metal);
+	memset(geometry, 0, sizeof(*geometry));
+}
+
+void geometry_clear(const struct geometry* geometry, double* temperatures, int columns)
+{
+	for(size_t k = 0; k < (size_t)geometry->rows * columns; k++)
+	{
+		temperatures[k] = geometry->metal[k] ? temperatures[k] : 0.0;
+	}
+}
+
+double geometry_propagate(const double* restrict temperatures_last, double* restrict temperatures, int rows, int columns, const struct geometry* geometry)
+{
+	double my_temperature_change = 0.0;
+
+	#pragma omp parallel for reduction(max:my_temperature_change)
+	for(int i = 1; i <= rows; i++)
+	{
+		const double* restrict before = &temperatures_last[(size_t)(i - 1) * columns];
+		const double* restrict last = &temperatures_last[(size_t)i * columns];
+		const double* restrict after = &temperatures_last[(size_t)(i + 1) * columns];
+		double* restrict current = &temperatures[(size_t)i * columns];
+
+		// The runs have four neighbours of metal, like the cells of heat_propagate between the edges
+		for(int r = geometry->run_offsets[i - 1]; r < geometry->run_offsets[i]; r++)
+		{
+			const int end = geometry->runs[r].end;
+			#pragma omp simd reduction(max:my_temperature_change)
+			for(int j = geometry->runs[r].begin; j < end; j++)
+			{
+				current[j] = (last[j] == MAX_TEMPERATURE) ? MAX_TEMPERATURE : 0.25 * (before[j] + after[j] + last[j - 1] + last[j + 1]);
+				my_temperature_change = fmax(fabs(current[j] - last[j]), my_temperature_change);
+			}
+		}
+
+		// The other cells average the neighbours they have, summed in the same order
+		for(int c = geometry->cell_offsets[i - 1]; c < geometry->cell_offsets[i]; c++)
+		{
+			const int j = geometry->cells[c].column;
+			const int neighbours = geometry->cells[c].neighbours;
+			double sum = 0.0;
+			int count = 0;
+			if(neighbours & GEOMETRY_UP)
+			{
+				sum = before[j];
+				count++;
+			}
+			if(neighbours & GEOMETRY_DOWN)
+			{
+				sum = count ? sum + after[j] : after[j];
+				count++;
+			}
+			if(neighbours & GEOMETRY_LEFT)
+			{
+				sum = count ? sum + last[j - 1] : last[j - 1];
+				count++;
+			}
+			if(neighbours & GEOMETRY_RIGHT)
+			{
+				sum = count ? sum + last[j + 1] : last[j + 1];
+				count++;
+			}
+
+			// A cell of metal without any neighbour of metal has nowhere to take heat from
+			if(last[j] == MAX_TEMPERATURE || count == 0)
+			{
+				current[j] = last[j];
+			}
+			else
+			{
+				current[j] = (count == 4) ? 0.25 * sum : sum / count;
+			}
+			my_temperature_change = fmax(fabs(current[j] - last[j]), my_temperature_change);
+		}
+	}
+
+	return my_temperature_change;
+}
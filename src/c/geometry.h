@@ -0,0 +1,109 @@
+/**
+ * @file geometry.h
+ * @brief Plates that are not rectangles: holes and cut-outs, see --geometry.
+ * @details The geometry is described with the syntax of a source file (see sources.h), the temperature of every shape being 0 where it cuts the plate out and 1 where it puts metal back, in the order of the file; the plate starts as metal everywhere. A cell cut out does not change and is not a neighbour of any other: a cell of metal takes the average of its neighbours of metal, like a cell on the left or right edge of the plate averages the neighbours it has. The ghost rows at the top and bottom of the plate remain neighbours at 0, as in the original code.
+ * Every MPI process compiles the geometry of its rows into a compressed form where only metal is found: for every row, the runs of consecutive cells whose four neighbours are metal, which the kernel updates with the vectorised loop of heat_propagate, then the other cells of metal, each with the neighbours it has, which it updates one at a time. A plate full of metal gives bit for bit the results of heat_propagate, and the time of an iteration follows the area of metal rather than that of the plate.
+ **/
+
+#ifndef GEOMETRY_H_INCLUDED
+#define GEOMETRY_H_INCLUDED
+
+#include "slab.h"
+
+/**
+ * @brief The neighbours a cell of metal has, as bits of geometry_cell.neighbours.
+ **/
+enum geometry_neighbour
+{
+	GEOMETRY_UP = 1,
+	GEOMETRY_DOWN = 2,
+	GEOMETRY_LEFT = 4,
+	GEOMETRY_RIGHT = 8
+};
+
+/**
+ * @brief Consecutive cells of a row whose four neighbours are metal: columns begin to end excluded.
+ **/
+struct geometry_run
+{
+	int begin;
+	int end;
+};
+
+/**
+ * @brief A cell of metal missing a neighbour.
+ **/
+struct geometry_cell
+{
+	/// The column of the cell.
+	int column;
+	/// The neighbours it has, a combination of enum geometry_neighbour.
+	int neighbours;
+};
+
+/**
+ * @brief The metal of a slab, stored like a compressed sparse row matrix.
+ **/
+struct geometry
+{
+	/// The number of rows in the slab.
+	int rows;
+	/// The runs of row i are runs[run_offsets[i]] to runs[run_offsets[i + 1]] excluded; rows + 1 entries.
+	int* run_offsets;
+	/// The runs of every row, in increasing order of column.
+	struct geometry_run* runs;
+	/// The other cells of metal of row i are cells[cell_offsets[i]] to cells[cell_offsets[i + 1]] excluded; rows + 1 entries.
+	int* cell_offsets;
+	/// The other cells of metal of every row, in increasing order of column.
+	struct geometry_cell* cells;
+	/// Whether each cell of the slab is metal, rows * columns without ghost rows.
+	unsigned char* metal;
+	/// The number of cells of metal in the slab.
+	long long metal_cells;
+};
+
+/**
+ * @brief Compiles the metal of a slab.
+ * @param[out] geometry The compiled metal.
+ * @param[in] metal Whether each cell is metal, (rows + 2) * columns with ghost rows; the ghost rows at the edges of the plate must be metal, since they are neighbours at 0.
+ * @param[in] rows The number of rows in the slab, ghost rows excluded.
+ * @param[in] columns The number of columns, at least 2.
+ * @return 0 on success, -1 if the memory cannot be allocated.
+ **/
+int geometry_build(struct geometry* geometry, const unsigned char* metal, int rows, int columns);
+
+/**
+ * @brief Compiles the metal of a slab from the description of the geometry.
+ * @details Every MPI process compiles the rows around its slab too, so no communication is needed.
+ * @param[out] geometry The compiled metal.
+ * @param[in] slab The slab.
+ * @param[in] path The path of the description.
+ * @return 0 on success, -1 if the description cannot be read or has a value other than 0 or 1 or follows a schedule, in which case a message has been printed on stderr, or if the memory cannot be allocated.
+ **/
+int geometry_create(struct geometry* geometry, const struct slab* slab, const char* path);
+
+/**
+ * @brief Releases the compiled metal.
+ **/
+void geometry_destroy(struct geometry* geometry);
+
+/**
+ * @brief Sets the cells of a slab that are not metal to 0.
+ * @param[in] geometry The compiled metal.
+ * @param[in,out] temperatures The first row of the slab, rows * columns.
+ * @param[in] columns The number of columns.
+ **/
+void geometry_clear(const struct geometry* geometry, double* temperatures, int columns);
+
+/**
+ * @brief Propagates the temperatures of a C slab by one iteration like heat_propagate, on its metal only.
+ * @param[in] temperatures_last The temperatures at the previous iteration, ghost rows included.
+ * @param[out] temperatures The temperatures at this iteration; ghost rows and cells that are not metal are not written.
+ * @param[in] rows The number of rows in the slab, ghost rows excluded.
+ * @param[in] columns The number of columns, at least 2.
+ * @param[in] geometry The compiled metal of the slab.
+ * @return The maximum absolute temperature change in the slab.
+ **/
+double geometry_propagate(const double* restrict temperatures_last, double* restrict temperatures, int rows, int columns, const struct geometry* geometry);
+
+#endif
@@ -0,0 +1,395 @@
+/**
+ * @file golden.c
+ * @brief Serial reference implementation of one iteration.
+ **/
+
+#include <string.h>
+#include <math.h>
+
+#include "kernels.h"
+#include "golden.h"
+
+/**
+ * @brief Returns the temperature of a cell at the previous iteration; the plate is surrounded by cells at 0 above and below.
+ **/
+static double at(const double* temperatures_last, int rows, int columns, int i, int j)
+{
+	if(i < 0 || i >= rows)
+	{
+		return 0.0;
+	}
+	return temperatures_last[i * columns + j];
+}
+
+double golden_propagate(const double* temperatures_last, double* temperatures, int rows, int columns, int summation)
+{
+	double temperature_change = 0.0;
+	for(int i = 0; i < rows; i++)
+	{
+		for(int j = 0; j < columns; j++)
+		{
+			double last = temperatures_last[i * columns + j];
+			double up = at(temperatures_last, rows, columns, i - 1, j);
+			double down = at(temperatures_last, rows, columns, i + 1, j);
+			double value;
+			if(last == MAX_TEMPERATURE)
+			{
+				value = MAX_TEMPERATURE;
+			}
+			else if(j == 0)
+			{
+				value = (up + down + at(temperatures_last, rows, columns, i, j + 1)) / 3.0;
+			}
+			else if(j == columns - 1)
+			{
+				value = (up + down + at(temperatures_last, rows, columns, i, j - 1)) / 3.0;
+			}
+			else
+			{
+				double left = at(temperatures_last, rows, columns, i, j - 1);
+				double right = at(temperatures_last, rows, columns, i, j + 1);
+				value = (summation == HEAT_STRIPS_FIRST) ? 0.25 * (up + down + left + right) : 0.25 * (left + right + up + down);
+			}
+			temperatures[i * columns + j] = value;
+			if(fabs(value - last) > temperature_change)
+			{
+				temperature_change = fabs(value - last);
+			}
+		}
+	}
+	return temperature_change;
+}
+
+double golden_sor(const double* plate, const double* temperatures_last, double* temperatures, int rows, int columns, double omega)
+{
+	double temperature_change = 0.0;
+	memcpy(temperatures, temperatures_last, (size_t)rows * columns * sizeof(double));
+	for(int colour = 0; colour < 2; colour++)
+	{
+		for(int i = 0; i < rows; i++)
+		{
+			for(int j = 0; j < columns; j++)
+			{
+				if((i + j) % 2 != colour || plate[i * columns + j] == MAX_TEMPERATURE)
+				{
+					continue;
+				}
+				double up = at(temperatures, rows, columns, i - 1, j);
+				double down = at(temperatures, rows, columns, i + 1, j);
+				double target;
+				if(j == 0)
+				{
+					target = (up + down + at(temperatures, rows, columns, i, j + 1)) / 3.0;
+				}
+				else if(j == columns - 1)
+				{
+					target = (up + down + at(temperatures, rows, columns, i, j - 1)) / 3.0;
+				}
+				else
+				{
+					target = 0.25 * (up + down + at(temperatures, rows, columns, i, j - 1) + at(temperatures, rows, columns, i, j + 1));
+				}
+				double change = omega * (target - temperatures[i * columns + j]);
+				temperatures[i * columns + j] += change;
+				if(fabs(change) > temperature_change)
+				{
+					temperature_change = fabs(change);
+				}
+			}
+		}
+	}
+	return temperature_change;
+}
+
+double golden_chebyshev(const double* plate, const double* temperatures_last, double* temperatures, int rows, int columns, double omega)
+{
+	double temperature_change = 0.0;
+	for(int i = 0; i < rows; i++)
+	{
+		for(int j = 0; j < columns; j++)
+		{
+			if(plate[i * columns + j] == MAX_TEMPERATURE)
+			{
+				temperatures[i * columns + j] = temperatures_last[i * columns + j];
+				continue;
+			}
+			double up = at(temperatures_last, rows, columns, i - 1, j);
+			double down = at(temperatures_last, rows, columns, i + 1, j);
+			double target;
+			if(j == 0)
+			{
+				target = (up + down + at(temperatures_last, rows, columns, i, j + 1)) / 3.0;
+			}
+			else if(j == columns - 1)
+			{
+				target = (up + down + at(temperatures_last, rows, columns, i, j - 1)) / 3.0;
+			}
+			else
+			{
+				target = 0.25 * (up + down + at(temperatures_last, rows, columns, i, j - 1) + at(temperatures_last, rows, columns, i, j + 1));
+			}
+			temperatures[i * columns + j] += omega * (target - temperatures[i * columns + j]);
+			double change = fabs(temperatures[i * columns + j] - temperatures_last[i * columns + j]);
+			if(change > temperature_change)
+			{
+				temperature_change = change;
+			}
+		}
+	}
+	return temperature_change;
+}
+
+/**
+ * @brief Returns the temperature of a cell at the previous iteration as its neighbours see it: the value of a fixed cell, 0 above and below the plate.
+ **/
+static double fixed_at(const unsigned char* fixed, const double* values, const double* temperatures_last, int rows, int columns, int i, int j)
+{
+	if(i < 0 || i >= rows)
+	{
+		return 0.0;
+	}
+	return fixed[i * columns + j] ? values[i * columns + j] : temperatures_last[i * columns + j];
+}
+
+double golden_fixed(const unsigned char* fixed, const double* values, const double* temperatures_last, double* temperatures, int rows, int columns)
+{
+	double temperature_change = 0.0;
+	for(int i = 0; i < rows; i++)
+	{
+		for(int j = 0; j < columns; j++)
+		{
+			if(fixed[i * columns + j])
+			{
+				temperatures[i * columns + j] = values[i * columns + j];
+				continue;
+			}
+			double up = fixed_at(fixed, values, temperatures_last, rows, columns, i - 1, j);
+			double down = fixed_at(fixed, values, temperatures_last, rows, columns, i + 1, j);
+			double value;
+			if(j == 0)
+			{
+				value = (up + down + fixed_at(fixed, values, temperatures_last, rows, columns, i, j + 1)) / 3.0;
+			}
+			else if(j == columns - 1)
+			{
+				value = (up + down + fixed_at(fixed, values, temperatures_last, rows, columns, i, j - 1)) / 3.0;
+			}
+			else
+			{
+				value = 0.25 * (up + down + fixed_at(fixed, values, temperatures_last, rows, columns, i, j - 1) + fixed_at(fixed, values, temperatures_last, rows, columns, i, j + 1));
+			}
+			temperatures[i * columns + j] = value;
+			double change = fabs(value - temperatures_last[i * columns + j]);
+			if(change > temperature_change)
+			{
+				temperature_change = change;
+			}
+		}
+	}
+	return temperature_change;
+}
+
+/**
+ * @brief Returns the conductivity of the face between a cell and its neighbour, or of the edge beyond the cell: that of the cell above and below the plate, none on the left and right.
+ **/
+static double face_at(const double* map, int rows, int columns, int i, int j, int neighbour_i, int neighbour_j)
+{
+	const double cell = map[i * columns + j];
+	if(neighbour_j < 0 || neighbour_j >= columns)
+	{
+		return 0.0;
+	}
+	if(neighbour_i < 0 || neighbour_i >= rows)
+	{
+		return cell;
+	}
+	const double neighbour = map[neighbour_i * columns + neighbour_j];
+	return 2.0 * cell * neighbour / (cell + neighbour);
+}
+
+double golden_conductivity(const double* plate, const double* map, const double* temperatures_last, double* temperatures, int rows, int columns)
+{
+	double temperature_change = 0.0;
+	for(int i = 0; i < rows; i++)
+	{
+		for(int j = 0; j < columns; j++)
+		{
+			double last = temperatures_last[i * columns + j];
+			double value = last;
+			if(plate[i * columns + j] != MAX_TEMPERATURE)
+			{
+				double up = face_at(map, rows, columns, i, j, i - 1, j);
+				double down = face_at(map, rows, columns, i, j, i + 1, j);
+				double left = face_at(map, rows, columns, i, j, i, j - 1);
+				double right = face_at(map, rows, columns, i, j, i, j + 1);
+				// The missing side of an edge cell has no face, its neighbour only stands in as 0
+				double sum = up * at(temperatures_last, rows, columns, i - 1, j) + down * at(temperatures_last, rows, columns, i + 1, j);
+				sum += left * ((j > 0) ? temperatures_last[i * columns + j - 1] : 0.0);
+				sum += right * ((j < columns - 1) ? temperatures_last[i * columns + j + 1] : 0.0);
+				value = sum / (up + down + left + right);
+			}
+			temperatures[i * columns + j] = value;
+			if(fabs(value - last) > temperature_change)
+			{
+				temperature_change = fabs(value - last);
+			}
+		}
+	}
+	return temperature_change;
+}
+
+double golden_heat3d(const double* temperatures_last, double* temperatures, int planes, int rows, int columns)
+{
+	double temperature_change = 0.0;
+	const int plane_size = rows * columns;
+	for(int p = 0; p < planes; p++)
+	{
+		for(int i = 0; i < rows; i++)
+		{
+			for(int j = 0; j < columns; j++)
+			{
+				const int cell = p * plane_size + i * columns + j;
+				double last = temperatures_last[cell];
+				// The planes before and after are always neighbours, at 0 beyond the ends of the block
+				double sum = ((p > 0) ? temperatures_last[cell - plane_size] : 0.0) + ((p < planes - 1) ? temperatures_last[cell + plane_size] : 0.0);
+				int neighbours = 2;
+				if(i > 0)
+				{
+					sum += temperatures_last[cell - columns];
+					neighbours++;
+				}
+				if(i < rows - 1)
+				{
+					sum += temperatures_last[cell + columns];
+					neighbours++;
+				}
+				if(j > 0)
+				{
+					sum += temperatures_last[cell - 1];
+					neighbours++;
+				}
+				if(j < columns - 1)
+				{
+					sum += temperatures_last[cell + 1];
+					neighbours++;
+				}
+				double value = (last == MAX_TEMPERATURE) ? MAX_TEMPERATURE : sum / neighbours;
+				temperatures[cell] = value;
+				if(fabs(value - last) > temperature_change)
+				{
+					temperature_change = fabs(value - last);
+				}
+			}
+		}
+	}
+	return temperature_change;
+}
+
+/**
+ * @brief Returns the temperature of the neighbour of a cell beyond an edge of the plate at the previous iteration.
+ * @param[in] edge The edge, beyond which is the neighbour.
+ * @param[in] i The row of the cell.
+ * @param[in] j The column of the cell.
+ **/
+static double beyond(const struct boundary* boundary, enum boundary_edge edge, const double* temperatures_last, int rows, int columns, int i, int j)
+{
+	if(boundary->modes[edge] == BOUNDARY_FIXED)
+	{
+		return boundary->values[edge];
+	}
+	if(boundary->modes[edge] == BOUNDARY_INSULATED)
+	{
+		return temperatures_last[i * columns + j];
+	}
+	switch(edge)
+	{
+		case BOUNDARY_TOP:
+			return temperatures_last[(rows - 1) * columns + j];
+		case BOUNDARY_BOTTOM:
+			return temperatures_last[j];
+		case BOUNDARY_LEFT:
+			return temperatures_last[i * columns + columns - 1];
+		default:
+			return temperatures_last[i * columns];
+	}
+}
+
+double golden_boundary(const struct boundary* boundary, const double* temperatures_last, double* temperatures, int rows, int columns)
+{
+	double temperature_change = 0.0;
+	for(int i = 0; i < rows; i++)
+	{
+		for(int j = 0; j < columns; j++)
+		{
+			double last = temperatures_last[i * columns + j];
+			double up = (i > 0) ? temperatures_last[(i - 1) * columns + j] : beyond(boundary, BOUNDARY_TOP, temperatures_last, rows, columns, i, j);
+			double down = (i < rows - 1) ? temperatures_last[(i + 1) * columns + j] : beyond(boundary, BOUNDARY_BOTTOM, temperatures_last, rows, columns, i, j);
+			double left = (j > 0) ? temperatures_last[i * columns + j - 1] : beyond(boundary, BOUNDARY_LEFT, temperatures_last, rows, columns, i, j);
+			double right = (j < columns - 1) ? temperatures_last[i * columns + j + 1] : beyond(boundary, BOUNDARY_RIGHT, temperatures_last, rows, columns, i, j);
+			double value;
+			if(last == MAX_TEMPERATURE)
+			{
+				value = MAX_TEMPERATURE;
+			}
+			else if(j == 0 && boundary->modes[BOUNDARY_LEFT] == BOUNDARY_INSULATED)
+			{
+				value = (up + down + right) / 3.0;
+			}
+			else if(j == columns - 1 && boundary->modes[BOUNDARY_RIGHT] == BOUNDARY_INSULATED)
+			{
+				value = (up + down + left) / 3.0;
+			}
+			else
+			{
+				value = 0.25 * (up + down + left + right);
+			}
+			temperatures[i * columns + j] = value;
+			if(fabs(value - last) > temperature_change)
+			{
+				temperature_change = fabs(value - last);
+			}
+		}
+	}
+	return temperature_change;
+}
+
+double golden_geometry(const unsigned char* metal, const double* temperatures_last, double* temperatures, int rows, int columns)
+{
+	double temperature_change = 0.0;
+	for(int i = 0; i < rows; i++)
+	{
+		for(int j = 0; j < columns; j++)
+		{
+			double last = temperatures_last[i * columns + j];
+			double value = last;
+			if(metal[i * columns + j] && last != MAX_TEMPERATURE)
+			{
+				const int neighbour_rows[4] = {i - 1, i + 1, i, i};
+				const int neighbour_columns[4] = {j, j, j - 1, j + 1};
+				double sum = 0.0;
+				int count = 0;
+				for(int n = 0; n < 4; n++)
+				{
+					const int ni = neighbour_rows[n];
+					const int nj = neighbour_columns[n];
+					if(nj < 0 || nj >= columns || (ni >= 0 && ni < rows && !metal[ni * columns + nj]))
+					{
+						continue;
+					}
+					sum += at(temperatures_last, rows, columns, ni, nj);
+					count++;
+				}
+				if(count > 0)
+				{
+					value = (count == 4) ? 0.25 * sum : sum / count;
+				}
+			}
+			temperatures[i * columns + j] = value;
+			if(fabs(value - last) > temperature_change)
+			{
+				temperature_change = fabs(value - last);
+			}
+		}
+	}
+	return temperature_change;
+}
@@ -0,0 +1,111 @@
+/**
+ * @file golden.h
+ * @brief Serial reference implementation of one iteration, against which optimised kernels are checked.
+ * @details It is written to be obviously correct rather than fast: no ghost rows, no parallelism, every neighbour fetched through a bounds check.
+ **/
+
+#ifndef GOLDEN_H_INCLUDED
+#define GOLDEN_H_INCLUDED
+
+#include "boundary.h"
+
+/**
+ * @brief Propagates the temperatures of the entire plate by one iteration.
+ * @param[in] temperatures_last The temperatures at the previous iteration, rows * columns in row-major order.
+ * @param[out] temperatures The temperatures at this iteration, same layout.
+ * @param[in] rows The number of rows in the plate.
+ * @param[in] columns The number of columns in the plate, at least 2.
+ * @param[in] summation The order in which the four neighbours are summed, one of enum heat_summation.
+ * @return The maximum absolute temperature change across the plate.
+ **/
+double golden_propagate(const double* temperatures_last, double* temperatures, int rows, int columns, int summation);
+
+/**
+ * @brief Runs one red-black successive over-relaxation iteration on the entire plate.
+ * @details Red cells, whose row and column add up to an even number, are updated first, then black cells, each in place; see sor.h.
+ * @param[in] plate The initial plate, whose cells at MAX_TEMPERATURE are the fixed sources.
+ * @param[in] temperatures_last The temperatures at the previous iteration, rows * columns in row-major order.
+ * @param[out] temperatures The temperatures at this iteration, same layout.
+ * @param[in] rows The number of rows in the plate.
+ * @param[in] columns The number of columns in the plate, at least 2.
+ * @param[in] omega The relaxation factor.
+ * @return The maximum absolute temperature change across the plate.
+ **/
+double golden_sor(const double* plate, const double* temperatures_last, double* temperatures, int rows, int columns, double omega);
+
+/**
+ * @brief Runs one Jacobi iteration with Chebyshev extrapolation on the entire plate.
+ * @details Every cell that is not fixed moves from its temperature two iterations ago towards its Jacobi value by the factor omega; see chebyshev.h.
+ * @param[in] plate The initial plate, whose cells at MAX_TEMPERATURE are the fixed sources.
+ * @param[in] temperatures_last The temperatures at the previous iteration, rows * columns in row-major order.
+ * @param[in,out] temperatures On entry, the temperatures two iterations ago; on exit, the temperatures at this iteration, same layout.
+ * @param[in] rows The number of rows in the plate.
+ * @param[in] columns The number of columns in the plate, at least 2.
+ * @param[in] omega The extrapolation factor.
+ * @return The maximum absolute temperature change from the previous iteration across the plate.
+ **/
+double golden_chebyshev(const double* plate, const double* temperatures_last, double* temperatures, int rows, int columns, double omega);
+
+/**
+ * @brief Propagates the temperatures of the entire plate by one iteration, with the fixed cells given explicitly rather than by MAX_TEMPERATURE.
+ * @details Every fixed cell takes its value, which is also what its neighbours see, and takes no part in the maximum change; the other cells follow the rules of golden_propagate in the C order, whatever their temperature.
+ * @param[in] fixed The fixed cells, rows * columns in row-major order, 1 if fixed.
+ * @param[in] values The temperatures of the fixed cells, same layout; the other cells are not read.
+ * @param[in] temperatures_last The temperatures at the previous iteration, same layout.
+ * @param[out] temperatures The temperatures at this iteration, same layout.
+ * @param[in] rows The number of rows in the plate.
+ * @param[in] columns The number of columns in the plate, at least 2.
+ * @return The maximum absolute temperature change across the cells that are not fixed.
+ **/
+double golden_fixed(const unsigned char* fixed, const double* values, const double* temperatures_last, double* temperatures, int rows, int columns);
+
+/**
+ * @brief Propagates the temperatures of the entire plate by one iteration, every cell taking the average of its neighbours weighted by the conductivities of their faces.
+ * @details The face between two cells conducts the harmonic mean of their conductivities, that of the cell first; the faces beyond the top and bottom edges conduct that of the cell, towards a temperature of 0, and there is none beyond the left and right edges; see conductivity.h.
+ * @param[in] plate The initial plate, whose cells at MAX_TEMPERATURE are the fixed sources.
+ * @param[in] map The conductivity of every cell, rows * columns in row-major order.
+ * @param[in] temperatures_last The temperatures at the previous iteration, same layout.
+ * @param[out] temperatures The temperatures at this iteration, same layout.
+ * @param[in] rows The number of rows in the plate.
+ * @param[in] columns The number of columns in the plate, at least 2.
+ * @return The maximum absolute temperature change across the plate.
+ **/
+double golden_conductivity(const double* plate, const double* map, const double* temperatures_last, double* temperatures, int rows, int columns);
+
+/**
+ * @brief Propagates the temperatures of an entire block by one iteration with the 7-point stencil.
+ * @details Every cell takes the average of the neighbours it has, summed in the order front, back, up, down, left, right: the planes before and after always, 0 beyond the ends of the block, and the rows and columns on either side only inside the plane; see heat3d.h.
+ * @param[in] temperatures_last The temperatures at the previous iteration, planes * rows * columns, plane by plane in row-major order.
+ * @param[out] temperatures The temperatures at this iteration, same layout.
+ * @param[in] planes The number of planes in the block.
+ * @param[in] rows The number of rows in a plane.
+ * @param[in] columns The number of columns in a plane, at least 2.
+ * @return The maximum absolute temperature change across the block.
+ **/
+double golden_heat3d(const double* temperatures_last, double* temperatures, int planes, int rows, int columns);
+
+/**
+ * @brief Propagates the temperatures of the entire plate by one iteration with the conditions of its edges.
+ * @details Beyond a fixed edge lies its value, beyond a periodic edge the opposite end of the plate; a cell takes the average of its four neighbours then. A cell on an insulated left or right edge averages the 3 neighbours it has, a cell on an insulated top or bottom edge stands in for its missing neighbour itself; see boundary.h.
+ * @param[in] boundary The conditions.
+ * @param[in] temperatures_last The temperatures at the previous iteration, rows * columns in row-major order.
+ * @param[out] temperatures The temperatures at this iteration, same layout.
+ * @param[in] rows The number of rows in the plate.
+ * @param[in] columns The number of columns in the plate, at least 2.
+ * @return The maximum absolute temperature change across the plate.
+ **/
+double golden_boundary(const struct boundary* boundary, const double* temperatures_last, double* temperatures, int rows, int columns);
+
+/**
+ * @brief Propagates the temperatures of the entire plate by one iteration, with only the cells of metal conducting.
+ * @details A cell of metal takes the average of its neighbours of metal, summed in the order up, down, left, right, the cells above and below the plate being metal at 0; it keeps its temperature if it has none. The cells cut out keep theirs and are nobody's neighbours; see geometry.h.
+ * @param[in] metal Whether each cell is metal, rows * columns in row-major order.
+ * @param[in] temperatures_last The temperatures at the previous iteration, same layout.
+ * @param[out] temperatures The temperatures at this iteration, same layout.
+ * @param[in] rows The number of rows in the plate.
+ * @param[in] columns The number of columns in the plate, at least 2.
+ * @return The maximum absolute temperature change across the plate.
+ **/
+double golden_geometry(const unsigned char* metal, const double* temperatures_last, double* temperatures, int rows, int columns);
+
+#endif
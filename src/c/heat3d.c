@@ -0,0 +1,126 @@
+/**
+ * @file heat3d.c
+ * @brief The kernel of the 3D version.
+ **/
+
+#include <stddef.h>
+#include <math.h>
+
+#include "heat3d.h"
+
+void heat3d_tiles(int rows, int columns, int threads, int* tile_rows, int* tile_columns)
+{
+	// A column of a tile costs a cell in each of the four planes; columns are cut only when 8 full rows would not fit, so that the vectorised loop stays long
+	const int column_bytes = 4 * (int)sizeof(double);
+	*tile_columns = ((size_t)columns * column_bytes * 8 <= HEAT3D_TILE_BYTES) ? columns : HEAT3D_TILE_BYTES / (column_bytes * 8);
+	*tile_rows = HEAT3D_TILE_BYTES / (column_bytes * *tile_columns);
+
+	// Every thread needs a tile of its own
+	const int column_tiles = (columns + *tile_columns - 1) / *tile_columns;
+	const int rows_per_thread = (rows * column_tiles + threads - 1) / threads;
+	*tile_rows = (*tile_rows > rows_per_thread) ? rows_per_thread : *tile_rows;
+	*tile_rows = (*tile_rows < 1) ? 1 : (*tile_rows > rows) ? rows : *tile_rows;
+}
+
+/**
+ * @brief Propagates the cells of a row between two columns.
+ * @details Always inlined with constant neighbour rows, so that the rows inside a plane get a loop without any test on their neighbours.
+ **/
+static inline __attribute__((always_inline)) double propagate_row(const double* restrict front, const double* restrict up, const double* restrict last, const double* restrict down, const double* restrict back, double* restrict current, int begin, int end, int columns, const int has_up, const int has_down)
+{
+	double change = 0.0;
+	const double neighbours = 4.0 + has_up + has_down;
+	int j = begin;
+
+	// Process the cell on the left face, which has no left neighbour
+	if(j == 0)
+	{
+		double sum = front[0] + back[0];
+		sum = has_up ? sum + up[0] : sum;
+		sum = has_down ? sum + down[0] : sum;
+		sum += last[1];
+		current[0] = (last[0] == MAX_TEMPERATURE) ? MAX_TEMPERATURE : sum / (neighbours - 1.0);
+		change = fabs(current[0] - last[0]);
+		j++;
+	}
+
+	// Process the cells between the faces
+	const int inner_end = (end < columns - 1) ? end : columns - 1;
+	#pragma omp simd reduction(max:change)
+	for(int k = j; k < inner_end; k++)
+	{
+		double sum = front[k] + back[k];
+		sum = has_up ? sum + up[k] : sum;
+		sum = has_down ? sum + down[k] : sum;
+		sum += last[k - 1];
+		sum += last[k + 1];
+		current[k] = (last[k] == MAX_TEMPERATURE) ? MAX_TEMPERATURE : sum / neighbours;
+		change = fmax(fabs(current[k] - last[k]), change);
+	}
+
+	// Process the cell on the right face, which has no right neighbour
+	if(end == columns)
+	{
+		const int k = columns - 1;
+		double sum = front[k] + back[k];
+		sum = has_up ? sum + up[k] : sum;
+		sum = has_down ? sum + down[k] : sum;
+		sum += last[k - 1];
+		current[k] = (last[k] == MAX_TEMPERATURE) ? MAX_TEMPERATURE : sum / (neighbours - 1.0);
+		change = fmax(fabs(current[k] - last[k]), change);
+	}
+	return change;
+}
+
+double heat3d_propagate(const double* restrict temperatures_last, double* restrict temperatures, int planes, int rows, int columns, int tile_rows, int tile_columns)
+{
+	double my_temperature_change = 0.0;
+	const size_t plane_size = (size_t)rows * columns;
+	const int row_tiles = (rows + tile_rows - 1) / tile_rows;
+	const int column_tiles = (columns + tile_columns - 1) / tile_columns;
+
+	// Every thread streams its tiles through all the planes: each tile of the last temperatures is loaded once and reused by the next two planes
+	#pragma omp parallel for collapse(2) schedule(static) reduction(max:my_temperature_change)
+	for(int row_tile = 0; row_tile < row_tiles; row_tile++)
+	{
+		for(int column_tile = 0; column_tile < column_tiles; column_tile++)
+		{
+			const int first_row = row_tile * tile_rows;
+			const int end_row = (first_row + tile_rows < rows) ? first_row + tile_rows : rows;
+			const int begin = column_tile * tile_columns;
+			const int end = (begin + tile_columns < columns) ? begin + tile_columns : columns;
+			for(int p = 1; p <= planes; p++)
+			{
+				for(int i = first_row; i < end_row; i++)
+				{
+					const double* restrict last = &temperatures_last[(size_t)p * plane_size + (size_t)i * columns];
+					const double* restrict front = last - plane_size;
+					const double* restrict back = last + plane_size;
+					const double* restrict up = last - columns;
+					const double* restrict down = last + columns;
+					double* restrict current = &temperatures[(size_t)p * plane_size + (size_t)i * columns];
+					double change;
+					if(i > 0 && i < rows - 1)
+					{
+						change = propagate_row(front, up, last, down, back, current, begin, end, columns, 1, 1);
+					}
+					else if(rows == 1)
+					{
+						change = propagate_row(front, up, last, down, back, current, begin, end, columns, 0, 0);
+					}
+					else if(i == 0)
+					{
+						change = propagate_row(front, up, last, down, back, current, begin, end, columns, 0, 1);
+					}
+					else
+					{
+						change = propagate_row(front, up, last, down, back, current, begin, end, columns, 1, 0);
+					}
+					my_temperature_change = fmax(change, my_temperature_change);
+				}
+			}
+		}
+	}
+
+	return my_temperature_change;
+}
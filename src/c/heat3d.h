@@ -0,0 +1,37 @@
+/**
+ * @file heat3d.h
+ * @brief The kernel of the 3D version: a block of planes, each of rows and columns, with the 7-point stencil.
+ * @details The block is decomposed into slabs of consecutive planes with the same code as the plate: a plane of the block is a row of length rows * columns for struct slab, so its ghost planes are contiguous and exchanged without packing. The ghost planes at both ends of the block stay at 0, like the ghost rows of the plate, while the faces at the first and last rows and columns of every plane are insulated: a cell takes the average of the neighbours it has, 6 inside the block, 5 on a face, 4 on an edge. Cells at MAX_TEMPERATURE are sources and keep their temperature.
+ * A plane of a large block does not fit in cache, and the stencil reads three of them to write a fourth; a naive sweep reads every plane from memory three times. The kernel therefore cuts every plane into tiles of rows and columns and streams each tile through the planes, so that a tile of a plane is read from memory once and found in cache by the two planes after it.
+ **/
+
+#ifndef HEAT3D_H_INCLUDED
+#define HEAT3D_H_INCLUDED
+
+/// The cache each OpenMP thread can devote to its tile: the four tiles of planes it works on at a time must fit in it.
+#define HEAT3D_TILE_BYTES (256 * 1024)
+
+/**
+ * @brief Chooses the tiles of a plane: full rows if they fit, otherwise columns cut into blocks, and as many rows as fit in HEAT3D_TILE_BYTES without leaving a thread without a tile.
+ * @param[in] rows The number of rows in a plane.
+ * @param[in] columns The number of columns in a plane.
+ * @param[in] threads The number of OpenMP threads.
+ * @param[out] tile_rows The number of rows in a tile.
+ * @param[out] tile_columns The number of columns in a tile.
+ **/
+void heat3d_tiles(int rows, int columns, int threads, int* tile_rows, int* tile_columns);
+
+/**
+ * @brief Propagates the temperatures of a slab of planes by one iteration and calculates the maximum temperature change.
+ * @param[in] temperatures_last The temperatures at the previous iteration, ghost planes included: (planes + 2) * rows * columns.
+ * @param[out] temperatures The temperatures at this iteration; ghost planes are not written.
+ * @param[in] planes The number of planes in the slab, ghost planes excluded.
+ * @param[in] rows The number of rows in a plane.
+ * @param[in] columns The number of columns in a plane, at least 2.
+ * @param[in] tile_rows The number of rows in a tile, see heat3d_tiles.
+ * @param[in] tile_columns The number of columns in a tile, at least 1.
+ * @return The maximum absolute temperature change in the slab.
+ **/
+double heat3d_propagate(const double* restrict temperatures_last, double* restrict temperatures, int planes, int rows, int columns, int tile_rows, int tile_columns);
+
+#endif
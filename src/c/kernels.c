@@ -0,0 +1,63 @@
+/**
+ * @file kernels.c
+ * @brief The computational kernels of the CPU versions, shared by C and FORTRAN.
+ **/
+
+#include <stddef.h>
+#include <math.h>
+
+#include "kernels.h"
+
+/**
+ * @brief Propagates a range of strips with a given summation order.
+ * @details Always inlined with a constant summation, so that each order gets its own vectorised loop instead of a branch per cell.
+ **/
+static inline __attribute__((always_inline)) double propagate_strips(const double* restrict temperatures_last, double* restrict temperatures, int first_strip, int last_strip, int strip_length, const int summation)
+{
+	double my_temperature_change = 0.0;
+
+	// The update and the maximum temperature change are fused so that every cell is read once and written once per iteration.
+	#pragma omp parallel for reduction(max:my_temperature_change)
+	for(int i = first_strip; i <= last_strip; i++)
+	{
+		const double* restrict before = &temperatures_last[(size_t)(i - 1) * strip_length];
+		const double* restrict last = &temperatures_last[(size_t)i * strip_length];
+		const double* restrict after = &temperatures_last[(size_t)(i + 1) * strip_length];
+		double* restrict current = &temperatures[(size_t)i * strip_length];
+
+		// Process the cell at the beginning of the strip, which has no neighbour before it within the strip
+		current[0] = (last[0] == MAX_TEMPERATURE) ? MAX_TEMPERATURE : (before[0] + after[0] + last[1]) / 3.0;
+		my_temperature_change = fmax(fabs(current[0] - last[0]), my_temperature_change);
+
+		// Process all cells between the first and last ones excluded, which each has four neighbours
+		#pragma omp simd reduction(max:my_temperature_change)
+		for(int j = 1; j < strip_length - 1; j++)
+		{
+			double sum = (summation == HEAT_STRIPS_FIRST) ? before[j] + after[j] + last[j - 1] + last[j + 1]
+			                                              : last[j - 1] + last[j + 1] + before[j] + after[j];
+			current[j] = (last[j] == MAX_TEMPERATURE) ? MAX_TEMPERATURE : 0.25 * sum;
+			my_temperature_change = fmax(fabs(current[j] - last[j]), my_temperature_change);
+		}
+
+		// Process the cell at the end of the strip, which has no neighbour after it within the strip
+		const int end = strip_length - 1;
+		current[end] = (last[end] == MAX_TEMPERATURE) ? MAX_TEMPERATURE : (before[end] + after[end] + last[end - 1]) / 3.0;
+		my_temperature_change = fmax(fabs(current[end] - last[end]), my_temperature_change);
+	}
+
+	return my_temperature_change;
+}
+
+double heat_propagate_strips(const double* restrict temperatures_last, double* restrict temperatures, int first_strip, int last_strip, int strip_length, int summation)
+{
+	if(summation == HEAT_CELLS_FIRST)
+	{
+		return propagate_strips(temperatures_last, temperatures, first_strip, last_strip, strip_length, HEAT_CELLS_FIRST);
+	}
+	return propagate_strips(temperatures_last, temperatures, first_strip, last_strip, strip_length, HEAT_STRIPS_FIRST);
+}
+
+double heat_propagate(const double* restrict temperatures_last, double* restrict temperatures, int rows, int columns)
+{
+	return propagate_strips(temperatures_last, temperatures, 1, rows, columns, HEAT_STRIPS_FIRST);
+}
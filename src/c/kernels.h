@@ -0,0 +1,46 @@
+/**
+ * @file kernels.h
+ * @brief The computational kernels of the CPU versions, shared by C and FORTRAN.
+ * @details The kernels do not know whether the plate is split by rows (C) or by columns (FORTRAN); they work on strips. A strip is a row in the C layout and a column in the FORTRAN layout; either way its cells are contiguous in memory. A slab is a sequence of strips stored contiguously, preceded and followed by one ghost strip: strip 0 is the ghost strip before the slab, strips 1 to N are the strips of the slab and strip N + 1 is the ghost strip after it. Ghost strips at the edges of the plate stay at 0. The cells at both ends of a strip are on the edge of the plate and have only three neighbours.
+ * Because ghost strips are contiguous in both layouts, they are exchanged straight from the slab and need no packing.
+ **/
+
+#ifndef KERNELS_H_INCLUDED
+#define KERNELS_H_INCLUDED
+
+/**
+ * @brief Order in which the four neighbours of a cell are summed.
+ * @details Floating-point addition is not associative, so each version keeps the order of its original code to stay bit-for-bit identical to its reference output.
+ **/
+enum heat_summation
+{
+	/// Neighbour strips first, then neighbours within the strip: the order of the C version.
+	HEAT_STRIPS_FIRST = 0,
+	/// Neighbours within the strip first, then neighbour strips: the order of the FORTRAN version.
+	HEAT_CELLS_FIRST = 1
+};
+
+/**
+ * @brief Propagates the temperatures of a range of strips by one iteration and calculates the maximum temperature change.
+ * @details Cells at MAX_TEMPERATURE are the flame and keep their temperature. Every other cell takes the average of its neighbours. Processing a range lets the strips that need no ghost strip be processed while the ghost strips are being exchanged.
+ * @param[in] temperatures_last The temperatures at the previous iteration, starting with ghost strip 0.
+ * @param[out] temperatures The temperatures at this iteration, same layout; only the strips processed are written.
+ * @param[in] first_strip The first strip to process, at least 1.
+ * @param[in] last_strip The last strip to process, included.
+ * @param[in] strip_length The number of cells in a strip, at least 2.
+ * @param[in] summation The order in which neighbours are summed.
+ * @return The maximum absolute temperature change in the strips processed.
+ **/
+double heat_propagate_strips(const double* restrict temperatures_last, double* restrict temperatures, int first_strip, int last_strip, int strip_length, int summation);
+
+/**
+ * @brief Propagates the temperatures of a C slab by one iteration and calculates the maximum temperature change.
+ * @param[in] temperatures_last The temperatures at the previous iteration, ghost rows included.
+ * @param[out] temperatures The temperatures at this iteration; ghost rows are not written.
+ * @param[in] rows The number of rows in the slab, ghost rows excluded.
+ * @param[in] columns The number of columns, at least 2.
+ * @return The maximum absolute temperature change in the slab.
+ **/
+double heat_propagate(const double* restrict temperatures_last, double* restrict temperatures, int rows, int columns);
+
+#endif
@@ -0,0 +1,543 @@
+/**
+ * @file multigrid.c
+ * @brief Geometric multigrid V-cycles.
+ **/
+
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <mpi.h>
+
+#include "sor.h"
+#include "multigrid.h"
+
+/// The maximum number of levels in each list; every level halves the previous one so this is never reached.
+#define MAX_LEVELS 32
+/// The number of Gauss-Seidel sweeps on a level before descending to the coarser one.
+#define PRE_SWEEPS 2
+/// The number of Gauss-Seidel sweeps on a level after the correction of the coarser one is added.
+#define POST_SWEEPS 2
+/// The number of coefficients in the stencil of a coarse cell: the cell itself and its 8 neighbours.
+#define STENCIL_SIZE 9
+
+/**
+ * @brief Returns the index, in the stencil of a cell, of the coefficient of its neighbour at (di, dj).
+ **/
+static inline int stencil_index(int di, int dj)
+{
+	return (di + 1) * 3 + (dj + 1);
+}
+
+/**
+ * @brief Calculates the residual of a cell: its right-hand side minus the operator applied to the unknowns.
+ * @param[in] level The level.
+ * @param[in] stencil The stencils of the level, or NULL on the plate, whose operator is the one of the Jacobi iteration: 4 times the cell, 3 on the edges, minus its neighbours.
+ * @param[in] x The unknowns of the level, ghost rows included and up to date.
+ * @param[in] right_hand_side The right-hand side without ghost rows, NULL if 0.
+ * @param[in] i The row of the cell in the level, ghost rows excluded.
+ * @param[in] j The column of the cell.
+ * @return The residual, 0 for a fixed cell.
+ **/
+static inline double residual_at(const struct slab* level, const double* stencil, const double* x, const double* right_hand_side, int i, int j)
+{
+	const int columns = level->columns;
+	const size_t cell = (size_t)i * columns + j;
+	if(level->fixed[cell])
+	{
+		return 0.0;
+	}
+	const double residual = (right_hand_side == NULL) ? 0.0 : right_hand_side[cell];
+	const double* current = &x[(size_t)(i + 1) * columns];
+	if(stencil == NULL)
+	{
+		if(j == 0)
+		{
+			return residual + current[j - columns] + current[j + columns] + current[j + 1] - 3.0 * current[j];
+		}
+		if(j == columns - 1)
+		{
+			return residual + current[j - columns] + current[j + columns] + current[j - 1] - 3.0 * current[j];
+		}
+		return residual + current[j - columns] + current[j + columns] + current[j - 1] + current[j + 1] - 4.0 * current[j];
+	}
+
+	const double* coefficients = &stencil[cell * STENCIL_SIZE];
+	double product = 0.0;
+	for(int di = -1; di <= 1; di++)
+	{
+		for(int dj = -1; dj <= 1; dj++)
+		{
+			if(j + dj >= 0 && j + dj < columns)
+			{
+				product += coefficients[stencil_index(di, dj)] * current[di * columns + j + dj];
+			}
+		}
+	}
+	return residual - product;
+}
+
+/**
+ * @brief Runs Gauss-Seidel sweeps on a level.
+ * @details The plate couples a cell to its 4 direct neighbours only and is swept in red-black order by sor_sweep. Coarse levels also couple diagonal neighbours; they are swept in 4 colours, two cells of the same colour being 2 rows or 2 columns apart.
+ * @param[in] level The level.
+ * @param[in] stencil The stencils of the level, or NULL on the plate.
+ * @param[in,out] x The unknowns of the level, ghost rows included.
+ * @param[in] right_hand_side The right-hand side without ghost rows; NULL on the plate, where it is 0 and the unknowns are the temperatures.
+ * @param[in] sweeps The number of sweeps, each updating every colour once.
+ **/
+static void smooth(const struct slab* level, const double* stencil, double* x, const double* right_hand_side, int sweeps)
+{
+	const int columns = level->columns;
+	for(int sweep = 0; sweep < sweeps; sweep++)
+	{
+		if(stencil == NULL)
+		{
+			for(int colour = SOR_RED; colour <= SOR_BLACK; colour++)
+			{
+				slab_exchange_ghost_rows(level, x);
+				sor_sweep(x, level->fixed, level->rows, columns, level->first_global_row, colour, 1.0);
+			}
+			continue;
+		}
+
+		for(int colour = 0; colour < 4; colour++)
+		{
+			slab_exchange_ghost_rows(level, x);
+			const int row_parity = colour >> 1;
+			const int column_parity = colour & 1;
+			#pragma omp parallel for
+			for(int i = 0; i < level->rows; i++)
+			{
+				if(((level->first_global_row + i) & 1) != row_parity)
+				{
+					continue;
+				}
+				for(int j = column_parity; j < columns; j += 2)
+				{
+					const size_t cell = (size_t)i * columns + j;
+					if(!level->fixed[cell])
+					{
+						x[(size_t)(i + 1) * columns + j] += residual_at(level, stencil, x, right_hand_side, i, j) / stencil[cell * STENCIL_SIZE + stencil_index(0, 0)];
+					}
+				}
+			}
+		}
+	}
+}
+
+/**
+ * @brief Sums the residual of the cells of a level into the right-hand side of the coarse cells covering them, and zeroes the unknowns of the coarse level.
+ * @details Coarse row I covers rows 2I and 2I + 1 of the level and belongs to the MPI process holding row 2I. An MPI process whose first row is odd therefore sends the residual of that row to the MPI process above.
+ * @param[out] split_residuals Two rows of scratch: the residual sent up, and the one received from below.
+ **/
+static void restrict_residual(const struct slab* level, const double* stencil, double* x, const double* right_hand_side, struct slab* coarse, double* split_residuals)
+{
+	slab_exchange_ghost_rows(level, x);
+	const int columns = level->columns;
+	const int first_row = level->first_global_row;
+	const int end_row = first_row + level->rows;
+	double* sent = split_residuals;
+	double* received = &split_residuals[columns];
+	if(first_row & 1)
+	{
+		for(int j = 0; j < columns; j++)
+		{
+			sent[j] = residual_at(level, stencil, x, right_hand_side, 0, j);
+		}
+	}
+	MPI_Sendrecv(sent, (first_row & 1) ? columns : 0, MPI_DOUBLE, level->up_neighbour_rank, 2,
+				 received, ((end_row & 1) && end_row < level->total_rows) ? columns : 0, MPI_DOUBLE, level->down_neighbour_rank, 2, level->comm, MPI_STATUS_IGNORE);
+
+	double* coarse_right_hand_side = &coarse->temperatures[coarse->columns];
+	#pragma omp parallel for
+	for(int I = 0; I < coarse->rows; I++)
+	{
+		const int first = 2 * (coarse->first_global_row + I) - first_row;
+		for(int J = 0; J < coarse->columns; J++)
+		{
+			double sum = 0.0;
+			for(int i = first; i < first + 2 && first_row + i < level->total_rows; i++)
+			{
+				for(int j = 2 * J; j < 2 * J + 2 && j < columns; j++)
+				{
+					sum += (i < level->rows) ? residual_at(level, stencil, x, right_hand_side, i, j) : received[j];
+				}
+			}
+			coarse_right_hand_side[(size_t)I * coarse->columns + J] = sum;
+		}
+	}
+	#pragma omp parallel for
+	for(int I = 0; I < coarse->rows + 2; I++)
+	{
+		memset(&coarse->temperatures_last[(size_t)I * coarse->columns], 0, coarse->columns * sizeof(double));
+	}
+}
+
+/**
+ * @brief Interpolates the unknowns of the coarse level bilinearly and adds them to the cells of a level that are not fixed.
+ * @details A cell takes 9/16 of the coarse cell covering it, 3/16 of each of the nearest coarse cells beside it and above or below it, and 1/16 of the nearest diagonal one. Beyond the top and bottom of the plate the coarse ghost rows are at 0; beyond the left and right edges, the coarse cell covering the cell is used again.
+ **/
+static void prolongate(const struct slab* coarse, const struct slab* level, double* x)
+{
+	double* coarse_x = coarse->temperatures_last;
+	slab_exchange_ghost_rows(coarse, coarse_x);
+	const int columns = level->columns;
+	#pragma omp parallel for
+	for(int i = 0; i < level->rows; i++)
+	{
+		// The coarse row covering a row whose index in the level is odd may be the ghost row above
+		const int global_row = level->first_global_row + i;
+		const int I = global_row / 2 - coarse->first_global_row;
+		const double* row = &coarse_x[(size_t)(I + 1) * coarse->columns];
+		const double* other_row = &coarse_x[(size_t)(I + 1 + ((global_row & 1) ? 1 : -1)) * coarse->columns];
+		double* current = &x[(size_t)(i + 1) * columns];
+		const unsigned char* fixed = &level->fixed[(size_t)i * columns];
+		for(int j = 0; j < columns; j++)
+		{
+			if(fixed[j])
+			{
+				continue;
+			}
+			const int J = j / 2;
+			int other_J = J + ((j & 1) ? 1 : -1);
+			if(other_J < 0 || other_J >= coarse->columns)
+			{
+				other_J = J;
+			}
+			current[j] += 0.5625 * row[J] + 0.1875 * (other_row[J] + row[other_J]) + 0.0625 * other_row[other_J];
+		}
+	}
+}
+
+/**
+ * @brief Calculates the stencils of a coarse level: the operator of the level above, applied to the interpolated coarse unknowns and summed over the cells of every coarse cell.
+ * @details The stencils are probed rather than derived: unit values are placed on every third coarse cell in both directions, so that each coarse cell sees exactly one among itself and its 8 neighbours, and the residual of the interpolated unit values gives that coefficient of its stencil. Nine probes give every coefficient. The coarse operator thus knows exactly which cells of the level above are fixed and where the top and bottom of the plate lie, however coarse the level. A coarse cell whose stencil is 0 covers fixed cells only; it is fixed too.
+ * Since the probes go through the operations of the V-cycle, the stencils do not depend on the decomposition.
+ * @param[in] level The level above.
+ * @param[in] stencil The stencils of the level above, NULL if it is the plate.
+ * @param[out] x A buffer of the level above, ghost rows included, used as scratch.
+ * @param[in,out] coarse The coarse level; its fixed cells are set and its unknowns zeroed.
+ * @param[out] coarse_stencil The stencils of the coarse level.
+ * @param[out] split_residuals Two rows of scratch for restrict_residual.
+ **/
+static void build_stencil(const struct slab* level, const double* stencil, double* x, struct slab* coarse, double* coarse_stencil, double* split_residuals)
+{
+	const int coarse_columns = coarse->columns;
+	for(int probe = 0; probe < STENCIL_SIZE; probe++)
+	{
+		const int probe_row = probe / 3;
+		const int probe_column = probe % 3;
+		memset(x, 0, (size_t)(level->rows + 2) * level->columns * sizeof(double));
+		memset(coarse->temperatures_last, 0, (size_t)(coarse->rows + 2) * coarse_columns * sizeof(double));
+		for(int I = 0; I < coarse->rows; I++)
+		{
+			for(int J = 0; J < coarse_columns; J++)
+			{
+				if((coarse->first_global_row + I) % 3 == probe_row && J % 3 == probe_column)
+				{
+					coarse->temperatures_last[(size_t)(I + 1) * coarse_columns + J] = 1.0;
+				}
+			}
+		}
+		prolongate(coarse, level, x);
+		restrict_residual(level, stencil, x, NULL, coarse, split_residuals);
+
+		// The residual is minus the operator; the unit value seen by a coarse cell is the one of its neighbour in the probed position
+		for(int I = 0; I < coarse->rows; I++)
+		{
+			const int di = (probe_row - (coarse->first_global_row + I) % 3 + 4) % 3 - 1;
+			for(int J = 0; J < coarse_columns; J++)
+			{
+				const int dj = (probe_column - J % 3 + 4) % 3 - 1;
+				const size_t cell = (size_t)I * coarse_columns + J;
+				coarse_stencil[cell * STENCIL_SIZE + stencil_index(di, dj)] = -coarse->temperatures[(size_t)(I + 1) * coarse_columns + J];
+			}
+		}
+	}
+
+	for(size_t cell = 0; cell < (size_t)coarse->rows * coarse_columns; cell++)
+	{
+		coarse->fixed[cell] = coarse_stencil[cell * STENCIL_SIZE + stencil_index(0, 0)] == 0.0;
+	}
+}
+
+/**
+ * @brief Writes the operator of the plate as stencils, for when the plate itself has to be gathered.
+ * @return The stencils of the slab, to free, or NULL if the memory cannot be allocated.
+ **/
+static double* plate_stencil(const struct slab* plate)
+{
+	const int columns = plate->columns;
+	double* stencil = calloc((size_t)plate->rows * columns * STENCIL_SIZE, sizeof(double));
+	if(stencil == NULL)
+	{
+		return NULL;
+	}
+	for(size_t cell = 0; cell < (size_t)plate->rows * columns; cell++)
+	{
+		if(plate->fixed[cell])
+		{
+			continue;
+		}
+		const int j = (int)(cell % columns);
+		double* coefficients = &stencil[cell * STENCIL_SIZE];
+		coefficients[stencil_index(-1, 0)] = -1.0;
+		coefficients[stencil_index(1, 0)] = -1.0;
+		coefficients[stencil_index(0, 0)] = 2.0;
+		if(j > 0)
+		{
+			coefficients[stencil_index(0, -1)] = -1.0;
+			coefficients[stencil_index(0, 0)] += 1.0;
+		}
+		if(j < columns - 1)
+		{
+			coefficients[stencil_index(0, 1)] = -1.0;
+			coefficients[stencil_index(0, 0)] += 1.0;
+		}
+	}
+	return stencil;
+}
+
+/**
+ * @brief Runs a V-cycle from one of the levels held by the master MPI process alone.
+ **/
+static void cycle_gathered(struct multigrid* multigrid, int index)
+{
+	struct slab* level = &multigrid->gathered_levels[index];
+	const double* stencil = multigrid->gathered_stencils[index];
+	double* x = level->temperatures_last;
+	const double* right_hand_side = &level->temperatures[level->columns];
+
+	if(index == multigrid->gathered_level_count - 1)
+	{
+		// The coarsest level is small enough for the sweeps to solve it
+		smooth(level, stencil, x, right_hand_side, 2 * (level->rows + level->columns));
+		return;
+	}
+
+	smooth(level, stencil, x, right_hand_side, PRE_SWEEPS);
+	struct slab* coarse = &multigrid->gathered_levels[index + 1];
+	restrict_residual(level, stencil, x, right_hand_side, coarse, multigrid->split_residuals);
+	cycle_gathered(multigrid, index + 1);
+	prolongate(coarse, level, x);
+	smooth(level, stencil, x, right_hand_side, POST_SWEEPS);
+}
+
+/**
+ * @brief Runs a V-cycle from the plate, index 0, or from a distributed level.
+ **/
+static void cycle_distributed(struct multigrid* multigrid, struct slab* plate, int index)
+{
+	struct slab* level = (index == 0) ? plate : &multigrid->distributed_levels[index - 1];
+	const double* stencil = (index == 0) ? NULL : multigrid->distributed_stencils[index - 1];
+	double* x = level->temperatures_last;
+	const double* right_hand_side = (index == 0) ? NULL : &level->temperatures[level->columns];
+	const int columns = level->columns;
+
+	if(index == multigrid->distributed_level_count)
+	{
+		// The coarsest distributed level: the master MPI process calculates the correction of the entire level on its own
+		slab_exchange_ghost_rows(level, x);
+		#pragma omp parallel for
+		for(int i = 0; i < level->rows; i++)
+		{
+			for(int j = 0; j < columns; j++)
+			{
+				multigrid->residual[(size_t)i * columns + j] = residual_at(level, stencil, x, right_hand_side, i, j);
+			}
+		}
+
+		struct slab* gathered = (multigrid->gathered_level_count > 0) ? &multigrid->gathered_levels[0] : NULL;
+		MPI_Gatherv(multigrid->residual, level->rows * columns, MPI_DOUBLE, gathered ? &gathered->temperatures[columns] : NULL, level->cell_counts, level->cell_offsets, MPI_DOUBLE, multigrid->root, level->comm);
+		if(gathered != NULL)
+		{
+			memset(gathered->temperatures_last, 0, (size_t)(gathered->rows + 2) * columns * sizeof(double));
+			cycle_gathered(multigrid, 0);
+		}
+		MPI_Scatterv(gathered ? &gathered->temperatures_last[columns] : NULL, level->cell_counts, level->cell_offsets, MPI_DOUBLE, multigrid->residual, level->rows * columns, MPI_DOUBLE, multigrid->root, level->comm);
+
+		// Fixed cells receive a correction of 0
+		#pragma omp parallel for
+		for(int i = 0; i < level->rows; i++)
+		{
+			for(int j = 0; j < columns; j++)
+			{
+				x[(size_t)(i + 1) * columns + j] += multigrid->residual[(size_t)i * columns + j];
+			}
+		}
+		return;
+	}
+
+	smooth(level, stencil, x, right_hand_side, PRE_SWEEPS);
+	struct slab* coarse = &multigrid->distributed_levels[index];
+	restrict_residual(level, stencil, x, right_hand_side, coarse, multigrid->split_residuals);
+	cycle_distributed(multigrid, plate, index + 1);
+	prolongate(coarse, level, x);
+	smooth(level, stencil, x, right_hand_side, POST_SWEEPS);
+}
+
+int multigrid_create(struct multigrid* multigrid, struct slab* plate, int root)
+{
+	memset(multigrid, 0, sizeof(*multigrid));
+	multigrid->root = root;
+	multigrid->distributed_levels = calloc(MAX_LEVELS, sizeof(struct slab));
+	multigrid->distributed_stencils = calloc(MAX_LEVELS, sizeof(double*));
+	multigrid->split_residuals = malloc(2 * (size_t)plate->columns * sizeof(double));
+	int allocated = multigrid->distributed_levels != NULL && multigrid->distributed_stencils != NULL && multigrid->split_residuals != NULL;
+	MPI_Allreduce(MPI_IN_PLACE, &allocated, 1, MPI_INT, MPI_MIN, plate->comm);
+	if(!allocated)
+	{
+		multigrid_destroy(multigrid);
+		return -1;
+	}
+
+	// Halve the plate as long as every MPI process keeps at least one row. Coarse row I covers rows 2I and 2I + 1 and belongs to the MPI process holding row 2I, so the levels only depend on the size of the plate, whatever its decomposition; the master MPI process gathers the coarsest distributed level and continues with the same rule.
+	struct slab* level = plate;
+	double* stencil = NULL;
+	for(;;)
+	{
+		const int coarse_rows = (level->first_global_row + level->rows + 1) / 2 - (level->first_global_row + 1) / 2;
+		int halvable = coarse_rows >= 1 && level->total_rows > 2 && level->columns > 2;
+		int everybody_halvable;
+		MPI_Allreduce(&halvable, &everybody_halvable, 1, MPI_INT, MPI_MIN, plate->comm);
+		if(!everybody_halvable)
+		{
+			break;
+		}
+		const int index = multigrid->distributed_level_count;
+		struct slab* coarse = &multigrid->distributed_levels[index];
+		if(slab_create_rows(coarse, plate->comm, coarse_rows, (level->columns + 1) / 2) != 0)
+		{
+			multigrid_destroy(multigrid);
+			return -1;
+		}
+		multigrid->distributed_level_count++;
+		multigrid->distributed_stencils[index] = malloc((size_t)coarse->rows * coarse->columns * STENCIL_SIZE * sizeof(double));
+		allocated = multigrid->distributed_stencils[index] != NULL;
+		MPI_Allreduce(MPI_IN_PLACE, &allocated, 1, MPI_INT, MPI_MIN, plate->comm);
+		if(!allocated)
+		{
+			multigrid_destroy(multigrid);
+			return -1;
+		}
+		// The temperatures of the plate are in temperatures_last, its other buffer is free until the first cycle
+		build_stencil(level, stencil, (level == plate) ? plate->temperatures : level->temperatures_last, coarse, multigrid->distributed_stencils[index], multigrid->split_residuals);
+		level = coarse;
+		stencil = multigrid->distributed_stencils[index];
+	}
+
+	const int count = level->rows * level->columns;
+	multigrid->residual = malloc((size_t)count * sizeof(double));
+	double* level_stencil = (level == plate) ? plate_stencil(plate) : stencil;
+	allocated = multigrid->residual != NULL && level_stencil != NULL;
+
+	// The master MPI process takes over the coarsest distributed level, with its stencils and fixed cells
+	struct slab* gathered = NULL;
+	if(plate->my_rank == root)
+	{
+		multigrid->gathered_levels = calloc(MAX_LEVELS, sizeof(struct slab));
+		multigrid->gathered_stencils = calloc(MAX_LEVELS, sizeof(double*));
+		if(multigrid->gathered_levels != NULL && multigrid->gathered_stencils != NULL && slab_create(&multigrid->gathered_levels[0], MPI_COMM_SELF, level->total_rows, level->columns) == 0)
+		{
+			multigrid->gathered_level_count = 1;
+			gathered = &multigrid->gathered_levels[0];
+			multigrid->gathered_stencils[0] = malloc((size_t)gathered->rows * gathered->columns * STENCIL_SIZE * sizeof(double));
+		}
+		allocated = allocated && gathered != NULL && multigrid->gathered_stencils[0] != NULL;
+	}
+	MPI_Allreduce(MPI_IN_PLACE, &allocated, 1, MPI_INT, MPI_MIN, plate->comm);
+	if(!allocated)
+	{
+		if(level == plate)
+		{
+			free(level_stencil);
+		}
+		multigrid_destroy(multigrid);
+		return -1;
+	}
+	MPI_Datatype stencil_type;
+	MPI_Type_contiguous(STENCIL_SIZE, MPI_DOUBLE, &stencil_type);
+	MPI_Type_commit(&stencil_type);
+	MPI_Gatherv(level_stencil, count, stencil_type, gathered ? multigrid->gathered_stencils[0] : NULL, level->cell_counts, level->cell_offsets, stencil_type, root, plate->comm);
+	MPI_Type_free(&stencil_type);
+	MPI_Gatherv(level->fixed, count, MPI_UNSIGNED_CHAR, gathered ? gathered->fixed : NULL, level->cell_counts, level->cell_offsets, MPI_UNSIGNED_CHAR, root, plate->comm);
+	if(level == plate)
+	{
+		free(level_stencil);
+	}
+
+	// It then keeps halving it while both dimensions are above 2, and tells the others whether it could
+	while(allocated && gathered != NULL && gathered->rows > 2 && gathered->columns > 2)
+	{
+		const int index = multigrid->gathered_level_count;
+		struct slab* coarse = &multigrid->gathered_levels[index];
+		if(slab_create(coarse, MPI_COMM_SELF, (gathered->rows + 1) / 2, (gathered->columns + 1) / 2) != 0)
+		{
+			allocated = 0;
+			break;
+		}
+		multigrid->gathered_level_count++;
+		multigrid->gathered_stencils[index] = malloc((size_t)coarse->rows * coarse->columns * STENCIL_SIZE * sizeof(double));
+		if(multigrid->gathered_stencils[index] == NULL)
+		{
+			allocated = 0;
+			break;
+		}
+		build_stencil(gathered, multigrid->gathered_stencils[index - 1], gathered->temperatures_last, coarse, multigrid->gathered_stencils[index], multigrid->split_residuals);
+		gathered = coarse;
+	}
+	MPI_Bcast(&allocated, 1, MPI_INT, root, plate->comm);
+	if(!allocated)
+	{
+		multigrid_destroy(multigrid);
+		return -1;
+	}
+	return 0;
+}
+
+double multigrid_cycle(struct multigrid* multigrid, struct slab* plate)
+{
+	const int columns = plate->columns;
+	double* temperatures = plate->temperatures_last;
+	double* temperatures_before = plate->temperatures;
+
+	#pragma omp parallel for
+	for(int i = 1; i <= plate->rows; i++)
+	{
+		memcpy(&temperatures_before[(size_t)i * columns], &temperatures[(size_t)i * columns], columns * sizeof(double));
+	}
+
+	cycle_distributed(multigrid, plate, 0);
+
+	double my_temperature_change = 0.0;
+	#pragma omp parallel for reduction(max:my_temperature_change)
+	for(int i = 1; i <= plate->rows; i++)
+	{
+		for(int j = 0; j < columns; j++)
+		{
+			my_temperature_change = fmax(fabs(temperatures[(size_t)i * columns + j] - temperatures_before[(size_t)i * columns + j]), my_temperature_change);
+		}
+	}
+	return my_temperature_change;
+}
+
+void multigrid_destroy(struct multigrid* multigrid)
+{
+	for(int i = 0; i < multigrid->distributed_level_count; i++)
+	{
+		slab_destroy(&multigrid->distributed_levels[i]);
+		free(multigrid->distributed_stencils[i]);
+	}
+	for(int i = 0; i < multigrid->gathered_level_count; i++)
+	{
+		slab_destroy(&multigrid->gathered_levels[i]);
+		free(multigrid->gathered_stencils[i]);
+	}
+	free(multigrid->distributed_levels);
+	free(multigrid->distributed_stencils);
+	free(multigrid->gathered_levels);
+	free(multigrid->gathered_stencils);
+	free(multigrid->residual);
+	free(multigrid->split_residuals);
+	memset(multigrid, 0, sizeof(*multigrid));
+}
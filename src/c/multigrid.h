@@ -0,0 +1,64 @@
+/**
+ * @file multigrid.h
+ * @brief Geometric multigrid V-cycles, an alternative to the Jacobi iteration when only the steady state matters.
+ * @details At the steady state, every cell that is not a source holds the average of its neighbours. The V-cycle smooths the temperatures of the plate with red-black Gauss-Seidel, which quickly removes the error that varies from one cell to the next, and corrects the smooth error that remains on coarser grids, where it varies quickly again.
+ * Each coarser level halves both dimensions; a coarse cell covers up to 2x2 cells of the level above. The residual of these cells is summed into the coarse cell and the correction calculated on the coarse level is interpolated bilinearly back. The operator of a coarse level is the one of the level above seen through these two operations, a 9-point stencil per coarse cell, so that sources of any shape, and the top and bottom of the plate, are accounted for exactly on every level. Coarse levels are smoothed with 4-colour Gauss-Seidel.
+ * Coarse levels are decomposed across the MPI processes by the parity of the rows: coarse row I covers rows 2I and 2I + 1 of the level above and belongs to the MPI process holding row 2I, so that an MPI process whose first row is odd passes its residual up. The levels are halved this way as long as every MPI process keeps at least one row; only that coarsest distributed level, a row or two per MPI process, is gathered on the master MPI process, which processes the remaining levels on its own. The levels only depend on the size of the plate, and since the correction of a coarse level starts from 0, it is the same whether the level is distributed or gathered: the temperatures do not depend on the decomposition.
+ **/
+
+#ifndef MULTIGRID_H_INCLUDED
+#define MULTIGRID_H_INCLUDED
+
+#include "slab.h"
+
+/**
+ * @brief The levels coarser than the plate.
+ * @details The slab of a coarse level holds the correction in temperatures_last, ghost rows included, and the right-hand side of the correction equation in the rows of temperatures.
+ **/
+struct multigrid
+{
+	/// The number of levels coarser than the plate decomposed like it.
+	int distributed_level_count;
+	/// The levels coarser than the plate decomposed like it, each half the previous one.
+	struct slab* distributed_levels;
+	/// The stencils of the distributed levels, 9 coefficients per cell.
+	double** distributed_stencils;
+	/// The residual of the coarsest distributed level, or of the plate if there is none, before it is gathered; it then receives the correction.
+	double* residual;
+	/// Two rows of the plate, for the residual of a row whose coarse row belongs to the MPI process above.
+	double* split_residuals;
+	/// The number of levels held by the master MPI process alone; 0 on the other MPI processes.
+	int gathered_level_count;
+	/// On the master MPI process only: the coarsest distributed level gathered, then coarser levels.
+	struct slab* gathered_levels;
+	/// On the master MPI process only: the stencils of the gathered levels.
+	double** gathered_stencils;
+	/// The rank of the MPI process on which the coarsest levels are gathered.
+	int root;
+};
+
+/**
+ * @brief Builds the levels coarser than a plate, their stencils and their fixed cells.
+ * @details This is a collective operation, to make once the plate has been scattered and its fixed cells are known. The coarse stencils take 9 / 4 times the memory of one buffer of the plate, plus a third for the levels below.
+ * @param[out] multigrid The levels to build.
+ * @param[in,out] plate The slab of the plate; plate->temperatures is used as scratch.
+ * @param[in] root The rank of the MPI process on which the coarsest levels are gathered.
+ * @return 0 on success, -1 on every MPI process if the memory cannot be allocated on one of them.
+ **/
+int multigrid_create(struct multigrid* multigrid, struct slab* plate, int root);
+
+/**
+ * @brief Runs one V-cycle on the plate.
+ * @details This is a collective operation. The temperatures are updated in place in plate->temperatures_last; plate->temperatures is overwritten.
+ * @param[in,out] multigrid The coarse levels.
+ * @param[in,out] plate The slab of the plate.
+ * @return The maximum absolute temperature change of the cycle in the slab.
+ **/
+double multigrid_cycle(struct multigrid* multigrid, struct slab* plate);
+
+/**
+ * @brief Releases the memory of the coarse levels.
+ **/
+void multigrid_destroy(struct multigrid* multigrid);
+
+#endif
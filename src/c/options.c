@@ -0,0 +1,419 @@
+/**
+ * @file options.c
+ * @brief Parsing of the command-line options understood by the CPU version.
+ **/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <getopt.h>
+
+#include "options.h"
+
+/// The time step of the ADI solver when not given, in Jacobi iterations.
+#define DEFAULT_ADI_TIME_STEP 100.0
+
+#ifdef BIG
+	/// The reference output of this dataset, relative to the root of the repository.
+	#define DEFAULT_REFERENCE_PATH "reference/c/cpu_big.txt"
+#else
+	#define DEFAULT_REFERENCE_PATH "reference/c/cpu_small.txt"
+#endif
+
+/**
+ * @brief Prints the list of options understood.
+ * @param[in] program_name The name under which the program was launched.
+ **/
+static void print_usage(const char* program_name)
+{
+	fprintf(stderr, "Usage: %s [OPTIONS]\n", program_name);
+	fprintf(stderr, "  --hash              print the hash of the entire field after every snapshot\n");
+	fprintf(stderr, "  --dump FILE         write the entire field to FILE at the end of the run\n");
+	fprintf(stderr, "  --iterations N      stop after N iterations instead of after MAX_TIME seconds\n");
+	fprintf(stderr, "  --max-time S        stop after S seconds (default: MAX_TIME unless --iterations or --tolerance is given)\n");
+	fprintf(stderr, "  --tolerance T       stop as soon as the maximum temperature change falls below T\n");
+	fprintf(stderr, "  --check-interval N  with --tolerance, check the maximum temperature change every N iterations only (default 1)\n");
+	fprintf(stderr, "  --snapshot-interval N  gather a snapshot and print the maximum temperature change every N iterations (default: SNAPSHOT_INTERVAL)\n");
+	fprintf(stderr, "  --check-reference   abort at the first temperature change differing from %s\n", DEFAULT_REFERENCE_PATH);
+	fprintf(stderr, "  --reference FILE    abort at the first temperature change differing from FILE\n");
+	fprintf(stderr, "  --rows N            number of rows in the plate (default %d)\n", ROWS);
+	fprintf(stderr, "  --columns N         number of columns in the plate (default %d)\n", COLUMNS);
+	fprintf(stderr, "  --solver NAME       iterative method: jacobi (default), sor, multigrid, chebyshev, cg or adi\n");
+	fprintf(stderr, "  --omega W           relaxation factor of sor, in ]0, 2[ (default: optimal for the plate)\n");
+	fprintf(stderr, "  --adi-dt T          time step of adi, in Jacobi iterations (default %g)\n", DEFAULT_ADI_TIME_STEP);
+	fprintf(stderr, "  --warm-start F      with --tolerance, start from the steady state of the plate coarsened by F, 2 or 4\n");
+	fprintf(stderr, "  --parareal S        with --iterations, spread the iterations across S time slices with Parareal, S >= 2\n");
+	fprintf(stderr, "  --parareal-corrections K  maximum number of Parareal corrections (default S, which is exact)\n");
+	fprintf(stderr, "  --sources FILE      read the heat sources from FILE instead of those of the dataset\n");
+	fprintf(stderr, "  --conductivity FILE  with the jacobi solver, read the conductivity of every region of the plate from FILE (default: 1 everywhere)\n");
+	fprintf(stderr, "  --geometry FILE     with the jacobi solver, cut the holes described in FILE out of the plate\n");
+	fprintf(stderr, "  --boundary SPEC     with the jacobi solver, the conditions at the edges as EDGE=MODE[,EDGE=MODE]..., EDGE being top, bottom, left, right or all and MODE fixed[:VALUE], insulated or periodic (default: top=fixed,bottom=fixed,left=insulated,right=insulated)\n");
+	fprintf(stderr, "  --batch FILE        run the jobs listed in FILE, one line of options each, instead of a single run\n");
+	fprintf(stderr, "  --groups G          with --batch, split the MPI processes into G groups running jobs side by side (default: one per MPI process)\n");
+	fprintf(stderr, "  --serve SOCKET      stay resident and run the options received on the Unix domain socket SOCKET, one line per run\n");
+}
+
+int parse_positive_option(const char* what, const char* value, int* result)
+{
+	*result = atoi(value);
+	if(*result <= 0)
+	{
+		fprintf(stderr, "The %s must be strictly positive, got '%s'.\n", what, value);
+		return -1;
+	}
+	return 0;
+}
+
+int parse_positive_real_option(const char* what, const char* value, double* result)
+{
+	*result = atof(value);
+	if(*result <= 0.0)
+	{
+		fprintf(stderr, "The %s must be strictly positive, got '%s'.\n", what, value);
+		return -1;
+	}
+	return 0;
+}
+
+int parse_columns_option(const char* value, int* columns)
+{
+	*columns = atoi(value);
+	if(*columns < 2)
+	{
+		fprintf(stderr, "The number of columns must be at least 2, got '%s'.\n", value);
+		return -1;
+	}
+	return 0;
+}
+
+int report_unknown_option(char* argv[])
+{
+	fprintf(stderr, "Unknown option '%s'.\n", argv[optind - 1]);
+	return -1;
+}
+
+int check_no_operands(int argc, char* argv[])
+{
+	if(optind < argc)
+	{
+		fprintf(stderr, "Unexpected argument '%s'.\n", argv[optind]);
+		return -1;
+	}
+	return 0;
+}
+
+int parse_options(int argc, char* argv[], struct options* options)
+{
+	static const struct option long_options[] =
+	{
+		{"hash",       no_argument,       NULL, 'h'},
+		{"dump",       required_argument, NULL, 'd'},
+		{"iterations", required_argument, NULL, 'i'},
+		{"max-time",   required_argument, NULL, 't'},
+		{"tolerance",  required_argument, NULL, 'T'},
+		{"check-interval", required_argument, NULL, 'I'},
+		{"snapshot-interval", required_argument, NULL, 'n'},
+		{"check-reference", no_argument,  NULL, 'R'},
+		{"reference",  required_argument, NULL, 'f'},
+		{"rows",       required_argument, NULL, 'r'},
+		{"columns",    required_argument, NULL, 'c'},
+		{"solver",     required_argument, NULL, 's'},
+		{"omega",      required_argument, NULL, 'w'},
+		{"adi-dt",     required_argument, NULL, 'a'},
+		{"warm-start", required_argument, NULL, 'W'},
+		{"parareal",   required_argument, NULL, 'p'},
+		{"parareal-corrections", required_argument, NULL, 'P'},
+		{"sources",    required_argument, NULL, 'o'},
+		{"conductivity", required_argument, NULL, 'k'},
+		{"geometry",   required_argument, NULL, 'G'},
+		{"boundary",   required_argument, NULL, 'B'},
+		{"batch",      required_argument, NULL, 'b'},
+		{"groups",     required_argument, NULL, 'g'},
+		{"serve",      required_argument, NULL, 'S'},
+		{NULL,         0,                 NULL, 0}
+	};
+
+	options->hash = 0;
+	options->dump_path = NULL;
+	options->max_iterations = 0;
+	options->max_time = 0.0;
+	options->tolerance = 0.0;
+	options->check_interval = 1;
+	options->snapshot_interval = 0;
+	options->reference_path = NULL;
+	options->rows = ROWS;
+	options->columns = COLUMNS;
+	options->solver = SOLVER_JACOBI;
+	options->omega = 0.0;
+	options->adi_time_step = DEFAULT_ADI_TIME_STEP;
+	options->warm_start_factor = 0;
+	options->parareal_slices = 0;
+	options->parareal_corrections = 0;
+	options->sources_path = NULL;
+	options->conductivity_path = NULL;
+	options->geometry_path = NULL;
+	boundary_default(&options->boundary);
+	options->batch_path = NULL;
+	options->groups = 0;
+	options->serve_path = NULL;
+
+	// Reset getopt so that the options can be parsed more than once
+	optind = 0;
+	opterr = 0;
+	int option;
+	while((option = getopt_long(argc, argv, "", long_options, NULL)) != -1)
+	{
+		int status = 0;
+		switch(option)
+		{
+			case 'h':
+				options->hash = 1;
+				break;
+			case 'd':
+				options->dump_path = optarg;
+				break;
+			case 'i':
+				status = parse_positive_option("number of iterations", optarg, &options->max_iterations);
+				break;
+			case 't':
+				status = parse_positive_real_option("maximum time", optarg, &options->max_time);
+				break;
+			case 'T':
+				status = parse_positive_real_option("tolerance", optarg, &options->tolerance);
+				break;
+			case 'I':
+				status = parse_positive_option("check interval", optarg, &options->check_interval);
+				break;
+			case 'n':
+				status = parse_positive_option("snapshot interval", optarg, &options->snapshot_interval);
+				break;
+			case 'R':
+				options->reference_path = DEFAULT_REFERENCE_PATH;
+				break;
+			case 'f':
+				options->reference_path = optarg;
+				break;
+			case 'r':
+				status = parse_positive_option("number of rows", optarg, &options->rows);
+				break;
+			case 'c':
+				status = parse_columns_option(optarg, &options->columns);
+				break;
+			case 's':
+				if(strcmp(optarg, "jacobi") == 0)
+				{
+					options->solver = SOLVER_JACOBI;
+				}
+				else if(strcmp(optarg, "sor") == 0)
+				{
+					options->solver = SOLVER_SOR;
+				}
+				else if(strcmp(optarg, "multigrid") == 0)
+				{
+					options->solver = SOLVER_MULTIGRID;
+				}
+				else if(strcmp(optarg, "chebyshev") == 0)
+				{
+					options->solver = SOLVER_CHEBYSHEV;
+				}
+				else if(strcmp(optarg, "cg") == 0)
+				{
+					options->solver = SOLVER_CG;
+				}
+				else if(strcmp(optarg, "adi") == 0)
+				{
+					options->solver = SOLVER_ADI;
+				}
+				else
+				{
+					fprintf(stderr, "Unknown solver '%s'.\n", optarg);
+					status = -1;
+				}
+				break;
+			case 'w':
+				options->omega = atof(optarg);
+				if(options->omega <= 0.0 || options->omega >= 2.0)
+				{
+					fprintf(stderr, "The relaxation factor must be in ]0, 2[, got '%s'.\n", optarg);
+					status = -1;
+				}
+				break;
+			case 'a':
+				status = parse_positive_real_option("time step", optarg, &options->adi_time_step);
+				break;
+			case 'W':
+				options->warm_start_factor = atoi(optarg);
+				if(options->warm_start_factor != 2 && options->warm_start_factor != 4)
+				{
+					fprintf(stderr, "The warm start coarsening factor must be 2 or 4, got '%s'.\n", optarg);
+					status = -1;
+				}
+				break;
+			case 'p':
+				options->parareal_slices = atoi(optarg);
+				if(options->parareal_slices < 2)
+				{
+					fprintf(stderr, "The number of Parareal time slices must be at least 2, got '%s'.\n", optarg);
+					status = -1;
+				}
+				break;
+			case 'P':
+				status = parse_positive_option("number of Parareal corrections", optarg, &options->parareal_corrections);
+				break;
+			case 'o':
+				options->sources_path = optarg;
+				break;
+			case 'k':
+				options->conductivity_path = optarg;
+				break;
+			case 'G':
+				options->geometry_path = optarg;
+				break;
+			case 'B':
+				if(boundary_parse(&options->boundary, optarg) != 0)
+				{
+					fprintf(stderr, "The boundary conditions must be EDGE=MODE items separated by commas, with periodic edges in opposite pairs, got '%s'.\n", optarg);
+					status = -1;
+				}
+				break;
+			case 'b':
+				options->batch_path = optarg;
+				break;
+			case 'g':
+				status = parse_positive_option("number of groups", optarg, &options->groups);
+				break;
+			case 'S':
+				options->serve_path = optarg;
+				break;
+			default:
+				status = report_unknown_option(argv);
+				break;
+		}
+		if(status != 0)
+		{
+			print_usage(argv[0]);
+			return -1;
+		}
+	}
+
+	if(check_no_operands(argc, argv) != 0)
+	{
+		print_usage(argv[0]);
+		return -1;
+	}
+
+	if(options->reference_path != NULL && (options->rows != ROWS || options->columns != COLUMNS))
+	{
+		fprintf(stderr, "The reference outputs are for a %dx%d plate, they cannot be checked on a %dx%d plate.\n", ROWS, COLUMNS, options->rows, options->columns);
+		return -1;
+	}
+
+	if(options->reference_path != NULL && options->solver != SOLVER_JACOBI)
+	{
+		fprintf(stderr, "The reference outputs were made with the Jacobi solver, they cannot be checked with another one.\n");
+		return -1;
+	}
+
+	if(options->warm_start_factor > 0 && options->tolerance == 0.0)
+	{
+		fprintf(stderr, "The warm start solves the coarse plate to the tolerance, which --tolerance must give.\n");
+		return -1;
+	}
+
+	if(options->warm_start_factor > 0 && options->reference_path != NULL)
+	{
+		fprintf(stderr, "The reference outputs start from the cold plate, they cannot be checked with a warm start.\n");
+		return -1;
+	}
+
+	if(options->sources_path != NULL && options->reference_path != NULL)
+	{
+		fprintf(stderr, "The reference outputs are for the sources of the dataset, they cannot be checked with other sources.\n");
+		return -1;
+	}
+
+	if(options->sources_path != NULL && (options->warm_start_factor > 0 || options->parareal_slices > 0))
+	{
+		fprintf(stderr, "The warm start and Parareal tell sources by their temperature, MAX_TEMPERATURE, so they cannot run with --sources.\n");
+		return -1;
+	}
+
+	if(options->conductivity_path != NULL && (options->solver != SOLVER_JACOBI || options->warm_start_factor > 0 || options->parareal_slices > 0))
+	{
+		fprintf(stderr, "The conductivity map is only known to the Jacobi solver, without warm start nor Parareal.\n");
+		return -1;
+	}
+
+	if(options->conductivity_path != NULL && options->reference_path != NULL)
+	{
+		fprintf(stderr, "The reference outputs are for a plate of uniform conductivity, they cannot be checked with a conductivity map.\n");
+		return -1;
+	}
+
+	if(options->geometry_path != NULL && (options->solver != SOLVER_JACOBI || options->warm_start_factor > 0 || options->parareal_slices > 0 || options->sources_path != NULL || options->conductivity_path != NULL || !boundary_is_default(&options->boundary)))
+	{
+		fprintf(stderr, "The geometry is only known to the Jacobi solver, without warm start, Parareal, sources, conductivity map nor boundary conditions.\n");
+		return -1;
+	}
+
+	if(options->geometry_path != NULL && options->reference_path != NULL)
+	{
+		fprintf(stderr, "The reference outputs are for a rectangular plate, they cannot be checked with a geometry.\n");
+		return -1;
+	}
+
+	if(!boundary_is_default(&options->boundary) && (options->solver != SOLVER_JACOBI || options->warm_start_factor > 0 || options->parareal_slices > 0 || options->sources_path != NULL || options->conductivity_path != NULL))
+	{
+		fprintf(stderr, "The boundary conditions are only known to the Jacobi solver, without warm start, Parareal, sources nor conductivity map.\n");
+		return -1;
+	}
+
+	if(!boundary_is_default(&options->boundary) && options->reference_path != NULL)
+	{
+		fprintf(stderr, "The reference outputs are for the boundary conditions of the original code, they cannot be checked with others.\n");
+		return -1;
+	}
+
+	if(options->serve_path != NULL && options->batch_path != NULL)
+	{
+		fprintf(stderr, "The service runs the requests it receives, it cannot also run a batch.\n");
+		return -1;
+	}
+
+	if(options->groups > 0 && options->batch_path == NULL)
+	{
+		fprintf(stderr, "The number of groups needs --batch.\n");
+		return -1;
+	}
+
+	if(options->parareal_corrections > 0 && options->parareal_slices == 0)
+	{
+		fprintf(stderr, "The number of Parareal corrections needs --parareal.\n");
+		return -1;
+	}
+
+	if(options->parareal_slices > 0)
+	{
+		if(options->max_iterations == 0 || options->max_iterations % options->parareal_slices != 0)
+		{
+			fprintf(stderr, "Parareal cuts the iterations into time slices, so --iterations must give a multiple of %d.\n", options->parareal_slices);
+			return -1;
+		}
+		if(options->batch_path != NULL)
+		{
+			fprintf(stderr, "Parareal splits the MPI processes into groups itself, it cannot run in a batch.\n");
+			return -1;
+		}
+		if(options->solver != SOLVER_JACOBI || options->tolerance > 0.0 || options->reference_path != NULL || options->warm_start_factor > 0)
+		{
+			fprintf(stderr, "Parareal runs a fixed number of Jacobi iterations, without --solver, --tolerance, --reference or --warm-start.\n");
+			return -1;
+		}
+		if(options->parareal_corrections == 0)
+		{
+			options->parareal_corrections = options->parareal_slices;
+		}
+	}
+
+	return 0;
+}
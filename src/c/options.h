@@ -0,0 +1,127 @@
+/**
+ * @file options.h
+ * @brief Command-line options understood by the CPU version.
+ * @details Every MPI process parses the command line itself; since mpirun passes the same arguments to all of them, they all end up with the same options without any communication.
+ **/
+
+#ifndef OPTIONS_H_INCLUDED
+#define OPTIONS_H_INCLUDED
+
+#include "boundary.h"
+
+/**
+ * @brief The iterative methods a run can use.
+ **/
+enum solver
+{
+	/// The Jacobi iteration of the original code, against which the reference outputs were made.
+	SOLVER_JACOBI,
+	/// Red-black successive over-relaxation, see sor.h.
+	SOLVER_SOR,
+	/// Geometric multigrid V-cycles, see multigrid.h; every iteration is a V-cycle.
+	SOLVER_MULTIGRID,
+	/// The Jacobi iteration with Chebyshev acceleration, see chebyshev.h.
+	SOLVER_CHEBYSHEV,
+	/// Pipelined preconditioned conjugate gradients, see cg.h.
+	SOLVER_CG,
+	/// Alternating-direction implicit time stepping, see adi.h; every iteration is a time step.
+	SOLVER_ADI
+};
+
+/**
+ * @brief Options controlling a run.
+ **/
+struct options
+{
+	/// Print the hash of the entire field after every snapshot.
+	int hash;
+	/// If not NULL, the entire field is written to that file at the end of the run.
+	const char* dump_path;
+	/// If strictly positive, the run stops after that many iterations instead of after MAX_TIME seconds.
+	int max_iterations;
+	/// If strictly positive, the run stops after that many seconds; 0 if not given, see the main loop for what the default is.
+	double max_time;
+	/// If strictly positive, the run stops as soon as the maximum temperature change falls below it.
+	double tolerance;
+	/// When a tolerance is given, the number of iterations between two checks of the maximum temperature change.
+	int check_interval;
+	/// If strictly positive, the number of iterations between two snapshots; 0 if not given, in which case it is SNAPSHOT_INTERVAL.
+	int snapshot_interval;
+	/// If not NULL, the temperature changes are compared with that reference output as they are calculated, and the run aborts at the first difference.
+	const char* reference_path;
+	/// The number of rows in the plate, ROWS unless overridden.
+	int rows;
+	/// The number of columns in the plate, COLUMNS unless overridden.
+	int columns;
+	/// The iterative method.
+	enum solver solver;
+	/// The relaxation factor of SOLVER_SOR; 0 if not given, in which case the optimal one for the plate is used.
+	double omega;
+	/// The time step of SOLVER_ADI, in Jacobi iterations.
+	double adi_time_step;
+	/// If strictly positive, the factor by which the plate is coarsened for the warm start, see warm_start.h; requires a tolerance.
+	int warm_start_factor;
+	/// If strictly positive, the number of time slices across which the iterations are spread with Parareal, see parareal.h; requires a number of iterations.
+	int parareal_slices;
+	/// The maximum number of Parareal corrections, parareal_slices unless overridden.
+	int parareal_corrections;
+	/// If not NULL, the job list to run instead of a single run, see batch.h.
+	const char* batch_path;
+	/// With a job list, the number of groups of MPI processes running jobs side by side; 0 if not given, in which case every MPI process is a group of its own.
+	int groups;
+	/// If not NULL, the Unix domain socket on which runs are accepted instead of a single run, see service.h.
+	const char* serve_path;
+	/// If not NULL, the file describing the sources of the plate, see sources.h; otherwise the sources of the dataset.
+	const char* sources_path;
+	/// If not NULL, the file describing the holes and cut-outs of the plate, see geometry.h; otherwise the plate is a rectangle of metal.
+	const char* geometry_path;
+	/// The conditions at the edges of the plate.
+	struct boundary boundary;
+	/// If not NULL, the file describing the conductivity of the plate, see conductivity.h; otherwise 1 everywhere.
+	const char* conductivity_path;
+};
+
+/**
+ * @brief Parses the value of an option that must be a strictly positive integer.
+ * @details This and the functions below hold the parsing and the messages of the options that every CPU version, plate, block or ensemble, understands alike; each prints what is wrong on stderr and leaves the usage message to its caller.
+ * @param[in] what What the value is, as in "The <what> must be strictly positive".
+ * @param[in] value The value, as given on the command line.
+ * @param[out] result The value parsed.
+ * @return 0 on success, -1 if the value is not strictly positive.
+ **/
+int parse_positive_option(const char* what, const char* value, int* result);
+
+/**
+ * @brief Parses the value of an option that must be a strictly positive real, like --max-time or --tolerance.
+ * @return 0 on success, -1 if the value is not strictly positive.
+ **/
+int parse_positive_real_option(const char* what, const char* value, double* result);
+
+/**
+ * @brief Parses the value of --columns, which must be at least 2.
+ * @return 0 on success, -1 otherwise.
+ **/
+int parse_columns_option(const char* value, int* columns);
+
+/**
+ * @brief Reports the option getopt_long has just rejected.
+ * @return -1.
+ **/
+int report_unknown_option(char* argv[]);
+
+/**
+ * @brief Checks that getopt_long has left no argument that is not an option.
+ * @return 0 on success, -1 otherwise.
+ **/
+int check_no_operands(int argc, char* argv[]);
+
+/**
+ * @brief Fills the options from the command line.
+ * @param[in] argc The number of arguments, as received by main.
+ * @param[in] argv The arguments, as received by main.
+ * @param[out] options The options to fill.
+ * @return 0 on success, -1 if an option is not understood, in which case a usage message has been printed on stderr.
+ **/
+int parse_options(int argc, char* argv[], struct options* options);
+
+#endif
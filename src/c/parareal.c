@@ -0,0 +1,212 @@
+/**
+ * @file parareal.c
+ * @brief Parareal integration of the Jacobi iteration.
+ **/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <mpi.h>
+
+#include "kernels.h"
+#include "slab.h"
+#include "resample.h"
+#include "parareal.h"
+
+/// The coarsening factor of the plate of the coarse propagator, in both directions.
+#define COARSENING 2
+
+/**
+ * @brief What the first MPI process of a group needs to run the coarse propagator.
+ **/
+struct coarse_propagator
+{
+	/// The number of iterations on the coarse plate.
+	int iterations;
+	/// The number of rows of the coarse plate.
+	int rows;
+	/// The number of columns of the coarse plate.
+	int columns;
+	/// The start of the fine plate, gathered.
+	double* start;
+	/// The end of the fine plate, interpolated.
+	double* end;
+	/// The coarse temperatures at the previous iteration, ghost rows included.
+	double* temperatures_last;
+	/// The coarse temperatures at this iteration, ghost rows included.
+	double* temperatures;
+};
+
+/**
+ * @brief Runs the Jacobi iteration on the slab of a group from a start.
+ * @param[in,out] slab The slab of the group.
+ * @param[in] start The temperatures of the slab to start from, rows * columns.
+ * @param[out] end The temperatures of the slab after the iterations, rows * columns.
+ * @param[in] iterations The number of iterations.
+ **/
+static void propagate_fine(struct slab* slab, const double* start, double* end, int iterations)
+{
+	const size_t count = (size_t)slab->rows * slab->columns;
+	memcpy(&slab->temperatures_last[slab->columns], start, count * sizeof(double));
+	for(int k = 0; k < iterations; k++)
+	{
+		slab_exchange_ghost_rows(slab, slab->temperatures_last);
+		heat_propagate(slab->temperatures_last, slab->temperatures, slab->rows, slab->columns);
+		slab_swap(slab);
+	}
+	memcpy(end, &slab->temperatures_last[slab->columns], count * sizeof(double));
+}
+
+/**
+ * @brief Runs the Jacobi iteration on the coarsened plate of a group from a start, on the first MPI process of the group.
+ * @details The sources of the plate, the cells at MAX_TEMPERATURE in the start, keep their temperature in the end.
+ **/
+static void propagate_coarse(const struct slab* slab, struct coarse_propagator* coarse, const double* start, double* end)
+{
+	const int columns = slab->columns;
+	MPI_Gatherv(start, slab->rows * columns, MPI_DOUBLE, coarse->start, slab->cell_counts, slab->cell_offsets, MPI_DOUBLE, 0, slab->comm);
+	if(slab->my_rank == 0)
+	{
+		resample_coarsen(coarse->start, slab->total_rows, columns, COARSENING, &coarse->temperatures_last[coarse->columns]);
+		for(int k = 0; k < coarse->iterations; k++)
+		{
+			heat_propagate(coarse->temperatures_last, coarse->temperatures, coarse->rows, coarse->columns);
+			double* swap = coarse->temperatures_last;
+			coarse->temperatures_last = coarse->temperatures;
+			coarse->temperatures = swap;
+		}
+		resample_interpolate(&coarse->temperatures_last[coarse->columns], slab->total_rows, columns, COARSENING, coarse->end);
+		#pragma omp parallel for
+		for(size_t cell = 0; cell < (size_t)slab->total_rows * columns; cell++)
+		{
+			if(coarse->start[cell] == MAX_TEMPERATURE)
+			{
+				coarse->end[cell] = MAX_TEMPERATURE;
+			}
+		}
+	}
+	MPI_Scatterv(coarse->end, slab->cell_counts, slab->cell_offsets, MPI_DOUBLE, end, slab->rows * columns, MPI_DOUBLE, 0, slab->comm);
+}
+
+int parareal_run(double* plate, int rows, int columns, int iterations, int slices, int corrections, int root, MPI_Comm comm)
+{
+	int my_rank;
+	MPI_Comm_rank(comm, &my_rank);
+	int comm_size;
+	MPI_Comm_size(comm, &comm_size);
+
+	// A group is a block of consecutive ranks; the MPI processes at the same place in consecutive groups hold the same rows and pass them on
+	const int group_size = comm_size / slices;
+	const int group = my_rank / group_size;
+	const int previous_rank = (group > 0) ? my_rank - group_size : MPI_PROC_NULL;
+	const int next_rank = (group < slices - 1) ? my_rank + group_size : MPI_PROC_NULL;
+	MPI_Comm group_comm;
+	MPI_Comm_split(comm, group, my_rank, &group_comm);
+
+	struct slab slab;
+	if(slab_create(&slab, group_comm, rows, columns) != 0)
+	{
+		MPI_Comm_free(&group_comm);
+		return -1;
+	}
+	const int count = slab.rows * columns;
+	double* start = malloc((size_t)count * sizeof(double));
+	double* fine_end = malloc((size_t)count * sizeof(double));
+	double* coarse_end_before = malloc((size_t)count * sizeof(double));
+	double* coarse_end = malloc((size_t)count * sizeof(double));
+	double* end = malloc((size_t)count * sizeof(double));
+	struct coarse_propagator coarse = {0};
+	coarse.iterations = (iterations / slices + COARSENING * COARSENING - 1) / (COARSENING * COARSENING);
+	coarse.rows = (rows + COARSENING - 1) / COARSENING;
+	coarse.columns = (columns + COARSENING - 1) / COARSENING;
+	int allocated = start != NULL && fine_end != NULL && coarse_end_before != NULL && coarse_end != NULL && end != NULL;
+	if(slab.my_rank == 0)
+	{
+		coarse.start = malloc((size_t)rows * columns * sizeof(double));
+		coarse.end = malloc((size_t)rows * columns * sizeof(double));
+		coarse.temperatures_last = calloc((size_t)(coarse.rows + 2) * coarse.columns, sizeof(double));
+		coarse.temperatures = calloc((size_t)(coarse.rows + 2) * coarse.columns, sizeof(double));
+		allocated = allocated && coarse.start != NULL && coarse.end != NULL && coarse.temperatures_last != NULL && coarse.temperatures != NULL;
+	}
+	int everybody_allocated;
+	MPI_Allreduce(&allocated, &everybody_allocated, 1, MPI_INT, MPI_MIN, comm);
+
+	int correction = 0;
+	if(everybody_allocated)
+	{
+		// The first group starts from the plate, the others from the coarse propagation of the start of the group before
+		if(group == 0)
+		{
+			MPI_Scatterv(plate, slab.cell_counts, slab.cell_offsets, MPI_DOUBLE, start, count, MPI_DOUBLE, root, group_comm);
+		}
+		else
+		{
+			MPI_Recv(start, count, MPI_DOUBLE, previous_rank, 0, comm, MPI_STATUS_IGNORE);
+		}
+		propagate_coarse(&slab, &coarse, start, coarse_end_before);
+		memcpy(end, coarse_end_before, (size_t)count * sizeof(double));
+		MPI_Send(end, count, MPI_DOUBLE, next_rank, 0, comm);
+
+		double global_correction = 1.0;
+		while(correction < corrections && global_correction > 0.0)
+		{
+			// Every group runs the fine propagator over its slice at the same time
+			propagate_fine(&slab, start, fine_end, iterations / slices);
+
+			// Then the corrected starts go from each group to the next, through the coarse propagator
+			if(group > 0)
+			{
+				MPI_Recv(start, count, MPI_DOUBLE, previous_rank, 0, comm, MPI_STATUS_IGNORE);
+			}
+			propagate_coarse(&slab, &coarse, start, coarse_end);
+			double my_correction = 0.0;
+			#pragma omp parallel for reduction(max:my_correction)
+			for(int i = 0; i < count; i++)
+			{
+				// Once the start is exact, both coarse ends are equal and the end is exactly the fine one
+				const double corrected = fine_end[i] + (coarse_end[i] - coarse_end_before[i]);
+				my_correction = fmax(fabs(corrected - end[i]), my_correction);
+				end[i] = corrected;
+			}
+			MPI_Send(end, count, MPI_DOUBLE, next_rank, 0, comm);
+			double* swap = coarse_end_before;
+			coarse_end_before = coarse_end;
+			coarse_end = swap;
+			correction++;
+
+			MPI_Allreduce(&my_correction, &global_correction, 1, MPI_DOUBLE, MPI_MAX, comm);
+			if(my_rank == root)
+			{
+				printf("Parareal correction %d: %.18f\n", correction, global_correction);
+			}
+		}
+
+		// The end of the last group is the plate after all the iterations
+		if(group == slices - 1)
+		{
+			MPI_Gatherv(end, count, MPI_DOUBLE, coarse.start, slab.cell_counts, slab.cell_offsets, MPI_DOUBLE, 0, group_comm);
+			if(slab.my_rank == 0)
+			{
+				MPI_Send(coarse.start, rows * columns, MPI_DOUBLE, root, 1, comm);
+			}
+		}
+		if(my_rank == root)
+		{
+			MPI_Recv(plate, rows * columns, MPI_DOUBLE, (slices - 1) * group_size, 1, comm, MPI_STATUS_IGNORE);
+		}
+	}
+
+	free(start);
+	free(fine_end);
+	free(coarse_end_before);
+	free(coarse_end);
+	free(end);
+	free(coarse.start);
+	free(coarse.end);
+	free(coarse.temperatures_last);
+	free(coarse.temperatures);
+	slab_destroy(&slab);
+	MPI_Comm_free(&group_comm);
+	return everybody_allocated ? correction : -1;
+}
@@ -0,0 +1,30 @@
+/**
+ * @file parareal.h
+ * @brief Parareal integration, which spreads the iterations of the Jacobi iteration across groups of MPI processes once the plate cannot usefully be split further.
+ * @details The iterations are cut into as many time slices as there are groups, each group holding the entire plate decomposed across its MPI processes like a run of its own. Every correction, each group runs the fine propagator, the Jacobi iteration, over its slice from its current start in parallel with the other groups; then the starts are corrected one slice after the other with the coarse propagator:
+ * U(n + 1) = F(U(n) before) + G(U(n)) - G(U(n) before).
+ * The coarse propagator G runs a quarter of the iterations of the slice on the plate coarsened by 2 in both directions, see resample.h, on the first MPI process of the group; heat crosses a coarse cell in a quarter of the iterations it takes to cross the two cells it covers.
+ * After k corrections the first k slices are exact, so with as many corrections as slices the result is bit for bit that of the Jacobi iteration; fewer corrections trade exactness for time.
+ **/
+
+#ifndef PARAREAL_H_INCLUDED
+#define PARAREAL_H_INCLUDED
+
+#include <mpi.h>
+
+/**
+ * @brief Runs iterations of the Jacobi iteration on a plate with Parareal.
+ * @details This is a collective operation. The first group holds the root MPI process. The temperature changes of individual iterations are not known; the largest correction of every Parareal correction is printed instead.
+ * @param[in,out] plate On the root MPI process only: the initial plate on entry, the plate after the iterations on exit.
+ * @param[in] rows The number of rows of the plate, at least twice the number of MPI processes in a group.
+ * @param[in] columns The number of columns of the plate, at least 4.
+ * @param[in] iterations The number of iterations, a multiple of slices.
+ * @param[in] slices The number of time slices, which divides the number of MPI processes in comm.
+ * @param[in] corrections The maximum number of corrections; the run stops earlier once a correction changes nothing.
+ * @param[in] root The rank in comm of the MPI process holding the plate, in the first group.
+ * @param[in] comm The communicator.
+ * @return The number of corrections made, or -1 if the memory cannot be allocated.
+ **/
+int parareal_run(double* plate, int rows, int columns, int iterations, int slices, int corrections, int root, MPI_Comm comm);
+
+#endif
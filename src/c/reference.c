@@ -0,0 +1,85 @@
+/**
+ * @file reference.c
+ * @brief Checking of the temperature changes against a reference output while the program runs.
+ **/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "reference.h"
+
+int reference_load(struct reference* reference, const char* path)
+{
+	memset(reference, 0, sizeof(*reference));
+	FILE* file = fopen(path, "r");
+	if(file == NULL)
+	{
+		return -1;
+	}
+
+	int capacity = 0;
+	char line[256];
+	while(fgets(line, sizeof(line), file) != NULL)
+	{
+		int iteration;
+		char change[32];
+		if(sscanf(line, " Iteration %d: %31s", &iteration, change) != 2)
+		{
+			continue;
+		}
+		if(reference->count == capacity)
+		{
+			capacity = capacity ? capacity * 2 : 1024;
+			int* iterations = realloc(reference->iterations, capacity * sizeof(int));
+			char (*changes)[32] = realloc(reference->changes, capacity * sizeof(*changes));
+			if(iterations == NULL || changes == NULL)
+			{
+				free(iterations);
+				free(changes);
+				reference->iterations = NULL;
+				reference->changes = NULL;
+				fclose(file);
+				return -1;
+			}
+			reference->iterations = iterations;
+			reference->changes = changes;
+		}
+		reference->iterations[reference->count] = iteration;
+		strcpy(reference->changes[reference->count], change);
+		reference->count++;
+	}
+	fclose(file);
+	return reference->count > 0 ? 0 : -1;
+}
+
+int reference_check(struct reference* reference, int iteration, double temperature_change)
+{
+	while(reference->next < reference->count && reference->iterations[reference->next] < iteration)
+	{
+		reference->next++;
+	}
+	if(reference->next == reference->count || reference->iterations[reference->next] != iteration)
+	{
+		return 0;
+	}
+
+	// Print it the way the program prints it, so that the comparison is the one verify.sh makes
+	char change[32];
+	snprintf(change, sizeof(change), "%.18f", temperature_change);
+	const char* expected = reference->changes[reference->next];
+	// The FORTRAN versions print no leading 0
+	if(strcmp(change, expected) != 0 && !(change[0] == '0' && strcmp(change + 1, expected) == 0))
+	{
+		fprintf(stderr, "[FAILURE] Iteration %d differs from the reference: %s (reference) vs %s (you).\n", iteration, expected, change);
+		return -1;
+	}
+	return 0;
+}
+
+void reference_free(struct reference* reference)
+{
+	free(reference->iterations);
+	free(reference->changes);
+	memset(reference, 0, sizeof(*reference));
+}
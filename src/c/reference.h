@@ -0,0 +1,47 @@
+/**
+ * @file reference.h
+ * @brief Checking of the temperature changes against a reference output while the program runs.
+ * @details The reference is one of the files in the reference folder; only its "Iteration N: CHANGE" lines are used. Temperature changes are compared as printed, to the 18th decimal, like verify.sh does.
+ **/
+
+#ifndef REFERENCE_H_INCLUDED
+#define REFERENCE_H_INCLUDED
+
+/**
+ * @brief The temperature changes of a reference output.
+ **/
+struct reference
+{
+	/// The iterations of the snapshots, in increasing order.
+	int* iterations;
+	/// The temperature changes printed at these iterations.
+	char (*changes)[32];
+	/// The number of snapshots.
+	int count;
+	/// The index of the next snapshot to compare, snapshots being compared in order.
+	int next;
+};
+
+/**
+ * @brief Loads the temperature changes of a reference output.
+ * @param[out] reference The reference to fill.
+ * @param[in] path The path of the reference output.
+ * @return 0 on success, -1 if the file cannot be read or contains no iteration.
+ **/
+int reference_load(struct reference* reference, const char* path);
+
+/**
+ * @brief Compares a temperature change with the reference.
+ * @param[in,out] reference The reference.
+ * @param[in] iteration The iteration of the snapshot.
+ * @param[in] temperature_change The temperature change observed.
+ * @return 0 if the temperature change matches the reference or the reference does not go that far, -1 if it differs, in which case a message has been printed on stderr.
+ **/
+int reference_check(struct reference* reference, int iteration, double temperature_change);
+
+/**
+ * @brief Releases the memory of a reference.
+ **/
+void reference_free(struct reference* reference);
+
+#endif
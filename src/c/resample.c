@@ -0,0 +1,69 @@
+/**
+ * @file resample.c
+ * @brief Transfers of entire plates between a plate and a coarsened plate.
+ **/
+
+#include <stddef.h>
+#include <math.h>
+
+#include "resample.h"
+
+/**
+ * @brief Returns the temperature at a coarse cell, 0 beyond the top and bottom of the plate and the nearest column beyond the left and right edges.
+ **/
+static inline double coarse_at(const double* coarse, int coarse_rows, int coarse_columns, int I, int J)
+{
+	if(I < 0 || I >= coarse_rows)
+	{
+		return 0.0;
+	}
+	J = (J < 0) ? 0 : (J >= coarse_columns) ? coarse_columns - 1 : J;
+	return coarse[(size_t)I * coarse_columns + J];
+}
+
+void resample_coarsen(const double* plate, int rows, int columns, int factor, double* coarse)
+{
+	const int coarse_rows = (rows + factor - 1) / factor;
+	const int coarse_columns = (columns + factor - 1) / factor;
+	#pragma omp parallel for
+	for(int I = 0; I < coarse_rows; I++)
+	{
+		for(int J = 0; J < coarse_columns; J++)
+		{
+			int source = 0;
+			int count = 0;
+			double sum = 0.0;
+			for(int i = I * factor; i < (I + 1) * factor && i < rows; i++)
+			{
+				for(int j = J * factor; j < (J + 1) * factor && j < columns; j++)
+				{
+					source = source || plate[(size_t)i * columns + j] == MAX_TEMPERATURE;
+					sum += plate[(size_t)i * columns + j];
+					count++;
+				}
+			}
+			coarse[(size_t)I * coarse_columns + J] = source ? MAX_TEMPERATURE : sum / count;
+		}
+	}
+}
+
+void resample_interpolate(const double* coarse, int rows, int columns, int factor, double* plate)
+{
+	const int coarse_rows = (rows + factor - 1) / factor;
+	const int coarse_columns = (columns + factor - 1) / factor;
+	#pragma omp parallel for
+	for(int i = 0; i < rows; i++)
+	{
+		const double y = (i + 0.5) / factor - 0.5;
+		const int I = (int)floor(y);
+		const double wy = y - I;
+		for(int j = 0; j < columns; j++)
+		{
+			const double x = (j + 0.5) / factor - 0.5;
+			const int J = (int)floor(x);
+			const double wx = x - J;
+			plate[(size_t)i * columns + j] = (1.0 - wy) * ((1.0 - wx) * coarse_at(coarse, coarse_rows, coarse_columns, I, J) + wx * coarse_at(coarse, coarse_rows, coarse_columns, I, J + 1))
+			                               + wy * ((1.0 - wx) * coarse_at(coarse, coarse_rows, coarse_columns, I + 1, J) + wx * coarse_at(coarse, coarse_rows, coarse_columns, I + 1, J + 1));
+		}
+	}
+}
@@ -0,0 +1,32 @@
+/**
+ * @file resample.h
+ * @brief Transfers of entire plates between a plate and the plate coarsened by an integer factor in both directions.
+ * @details A coarse cell covers up to factor x factor cells of the plate. Sources are the cells at MAX_TEMPERATURE, as in slab_scatter.
+ **/
+
+#ifndef RESAMPLE_H_INCLUDED
+#define RESAMPLE_H_INCLUDED
+
+/**
+ * @brief Coarsens a plate.
+ * @details A coarse cell is a source if any of the cells it covers is, so that sources one cell wide survive the coarsening; otherwise it takes the average of the cells it covers.
+ * @param[in] plate The plate, rows * columns in row-major order.
+ * @param[in] rows The number of rows of the plate.
+ * @param[in] columns The number of columns of the plate.
+ * @param[in] factor The coarsening factor.
+ * @param[out] coarse The coarse plate, ceil(rows / factor) * ceil(columns / factor) in row-major order.
+ **/
+void resample_coarsen(const double* plate, int rows, int columns, int factor, double* coarse);
+
+/**
+ * @brief Interpolates a coarse plate bilinearly between the centres of the coarse cells.
+ * @details Beyond the top and bottom of the plate the coarse plate is at 0, beyond the left and right edges it takes the nearest coarse cell.
+ * @param[in] coarse The coarse plate, ceil(rows / factor) * ceil(columns / factor) in row-major order.
+ * @param[in] rows The number of rows of the plate.
+ * @param[in] columns The number of columns of the plate.
+ * @param[in] factor The coarsening factor.
+ * @param[out] plate The plate, rows * columns in row-major order.
+ **/
+void resample_interpolate(const double* coarse, int rows, int columns, int factor, double* plate);
+
+#endif
@@ -0,0 +1,85 @@
+/**
+ * @file service.c
+ * @brief The local Unix domain socket through which a resident CPU version accepts runs.
+ **/
+
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+#include "service.h"
+
+int service_listen(const char* path)
+{
+	struct sockaddr_un address;
+	memset(&address, 0, sizeof(address));
+	address.sun_family = AF_UNIX;
+	if(strlen(path) >= sizeof(address.sun_path))
+	{
+		fprintf(stderr, "The socket path \"%s\" is too long.\n", path);
+		return -1;
+	}
+	strcpy(address.sun_path, path);
+
+	int listener = socket(AF_UNIX, SOCK_STREAM, 0);
+	if(listener < 0)
+	{
+		perror("socket");
+		return -1;
+	}
+	unlink(path);
+	if(bind(listener, (struct sockaddr*)&address, sizeof(address)) != 0 || listen(listener, 16) != 0)
+	{
+		fprintf(stderr, "Cannot listen on \"%s\": %s.\n", path, strerror(errno));
+		close(listener);
+		return -1;
+	}
+	return listener;
+}
+
+int service_accept(int listener, char* request, size_t size)
+{
+	int client = accept(listener, NULL, NULL);
+	if(client < 0)
+	{
+		// A failure that lasts, like running out of file descriptors, must not turn the wait for the next client into a busy loop
+		if(errno != EINTR)
+		{
+			fprintf(stderr, "Cannot accept a client: %s.\n", strerror(errno));
+			sleep(SERVICE_ACCEPT_BACKOFF);
+		}
+		return -1;
+	}
+
+	// The request ends at the first line terminator, or when the client stops sending
+	size_t length = 0;
+	while(length < size - 1)
+	{
+		ssize_t received = read(client, &request[length], 1);
+		if(received <= 0 || request[length] == '\n')
+		{
+			break;
+		}
+		length++;
+	}
+	while(length > 0 && request[length - 1] == '\r')
+	{
+		length--;
+	}
+	request[length] = '\0';
+	if(length == 0)
+	{
+		close(client);
+		return -1;
+	}
+	return client;
+}
+
+void service_close(int listener, const char* path)
+{
+	close(listener);
+	unlink(path);
+}
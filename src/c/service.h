@@ -0,0 +1,39 @@
+/**
+ * @file service.h
+ * @brief The local Unix domain socket through which a resident CPU version accepts runs, see --serve.
+ * @details A client connects, sends one line: the options of the run, separated by spaces, like a line of a job list (see batch.h); "quit" stops the service instead. The output of the run is streamed back as it is printed, followed by a last line "Request complete: success." or "Request complete: failure.", after which the connection is closed. Requests are served one at a time.
+ * While the service waits for a client, the MPI processes other than the master wait for the next request inside MPI_Bcast, which most MPI implementations do by polling: each of them keeps a core busy even when the service is idle. With OpenMPI, setting the MCA parameter mpi_yield_when_idle to 1 makes them yield that core instead.
+ **/
+
+#ifndef SERVICE_H_INCLUDED
+#define SERVICE_H_INCLUDED
+
+#include <stddef.h>
+
+/**
+ * @brief The number of seconds to wait after a client could not be accepted before trying again.
+ **/
+#define SERVICE_ACCEPT_BACKOFF 1
+
+/**
+ * @brief Creates the socket of the service and listens to it.
+ * @param[in] path The path of the socket; a socket left there by a previous service is replaced.
+ * @return The listening socket, or -1 if it cannot be created, in which case a message has been printed on stderr.
+ **/
+int service_listen(const char* path);
+
+/**
+ * @brief Waits for the next client and reads its request.
+ * @param[in] listener The listening socket.
+ * @param[out] request The request, without its line terminator.
+ * @param[in] size The size of the request buffer; longer requests are truncated.
+ * @return The socket connected to the client, or -1 if no request could be read from the client that connected. If no client could be accepted at all, the reason has been printed on stderr and the call has waited SERVICE_ACCEPT_BACKOFF seconds before returning -1.
+ **/
+int service_accept(int listener, char* request, size_t size);
+
+/**
+ * @brief Closes the listening socket and removes it from the file system.
+ **/
+void service_close(int listener, const char* path);
+
+#endif
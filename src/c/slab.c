@@ -0,0 +1,174 @@
+/**
+ * @file slab.c
+ * @brief Decomposition of the plate into slabs of consecutive rows, one per MPI process.
+ **/
+
+#include <stdlib.h>
+#include <string.h>
+#include <mpi.h>
+
+#include "slab.h"
+
+/**
+ * @brief Allocates a buffer of the slab and zeroes it the way the kernels will traverse it.
+ **/
+static double* allocate_buffer(int rows, int columns)
+{
+	double* buffer = malloc((size_t)(rows + 2) * columns * sizeof(double));
+	if(buffer == NULL)
+	{
+		return NULL;
+	}
+	#pragma omp parallel for
+	for(int i = 0; i < rows + 2; i++)
+	{
+		memset(&buffer[(size_t)i * columns], 0, columns * sizeof(double));
+	}
+	return buffer;
+}
+
+/**
+ * @brief Records the decomposition given by the number of rows of every MPI process and allocates the slab of this one.
+ **/
+static int allocate_slab(struct slab* slab, const int* rows_per_process)
+{
+	slab->up_neighbour_rank = (slab->my_rank == 0) ? MPI_PROC_NULL : slab->my_rank - 1;
+	slab->down_neighbour_rank = (slab->my_rank == slab->comm_size - 1) ? MPI_PROC_NULL : slab->my_rank + 1;
+	int first_row = 0;
+	for(int i = 0; i < slab->comm_size; i++)
+	{
+		// rows_per_process may be cell_counts itself
+		const int rows = rows_per_process[i];
+		if(i == slab->my_rank)
+		{
+			slab->rows = rows;
+			slab->first_global_row = first_row;
+		}
+		slab->cell_counts[i] = rows * slab->columns;
+		slab->cell_offsets[i] = first_row * slab->columns;
+		first_row += rows;
+	}
+
+	slab->temperatures = allocate_buffer(slab->rows, slab->columns);
+	slab->temperatures_last = allocate_buffer(slab->rows, slab->columns);
+	slab->fixed = malloc((size_t)slab->rows * slab->columns);
+	if(slab->temperatures == NULL || slab->temperatures_last == NULL || slab->fixed == NULL)
+	{
+		slab_destroy(slab);
+		return -1;
+	}
+	return 0;
+}
+
+int slab_create(struct slab* slab, MPI_Comm comm, int total_rows, int columns)
+{
+	memset(slab, 0, sizeof(*slab));
+	slab->comm = comm;
+	MPI_Comm_rank(comm, &slab->my_rank);
+	MPI_Comm_size(comm, &slab->comm_size);
+	if(total_rows < slab->comm_size || columns < 2)
+	{
+		return -1;
+	}
+
+	slab->total_rows = total_rows;
+	slab->columns = columns;
+	slab->cell_counts = malloc(slab->comm_size * sizeof(int));
+	slab->cell_offsets = malloc(slab->comm_size * sizeof(int));
+	if(slab->cell_counts == NULL || slab->cell_offsets == NULL)
+	{
+		slab_destroy(slab);
+		return -1;
+	}
+	for(int i = 0; i < slab->comm_size; i++)
+	{
+		slab->cell_counts[i] = total_rows / slab->comm_size + (i < total_rows % slab->comm_size ? 1 : 0);
+	}
+	return allocate_slab(slab, slab->cell_counts);
+}
+
+int slab_create_rows(struct slab* slab, MPI_Comm comm, int rows, int columns)
+{
+	memset(slab, 0, sizeof(*slab));
+	slab->comm = comm;
+	MPI_Comm_rank(comm, &slab->my_rank);
+	MPI_Comm_size(comm, &slab->comm_size);
+	slab->columns = columns;
+	slab->cell_counts = malloc(slab->comm_size * sizeof(int));
+	slab->cell_offsets = malloc(slab->comm_size * sizeof(int));
+	int valid = rows >= 1 && columns >= 2 && slab->cell_counts != NULL && slab->cell_offsets != NULL;
+	int all_valid;
+	MPI_Allreduce(&valid, &all_valid, 1, MPI_INT, MPI_MIN, comm);
+	if(!all_valid)
+	{
+		slab_destroy(slab);
+		return -1;
+	}
+
+	MPI_Allgather(&rows, 1, MPI_INT, slab->cell_counts, 1, MPI_INT, comm);
+	for(int i = 0; i < slab->comm_size; i++)
+	{
+		slab->total_rows += slab->cell_counts[i];
+	}
+	valid = allocate_slab(slab, slab->cell_counts) == 0;
+	MPI_Allreduce(&valid, &all_valid, 1, MPI_INT, MPI_MIN, comm);
+	if(!all_valid)
+	{
+		slab_destroy(slab);
+		return -1;
+	}
+	return 0;
+}
+
+void slab_destroy(struct slab* slab)
+{
+	free(slab->cell_counts);
+	free(slab->cell_offsets);
+	free(slab->temperatures);
+	free(slab->temperatures_last);
+	free(slab->fixed);
+	slab->cell_counts = NULL;
+	slab->cell_offsets = NULL;
+	slab->temperatures = NULL;
+	slab->temperatures_last = NULL;
+	slab->fixed = NULL;
+}
+
+void slab_swap(struct slab* slab)
+{
+	double* swap = slab->temperatures_last;
+	slab->temperatures_last = slab->temperatures;
+	slab->temperatures = swap;
+}
+
+void slab_exchange_ghost_rows(const struct slab* slab, double* temperatures)
+{
+	const int columns = slab->columns;
+
+	// Send my first row up and receive the ghost row below from down. If a neighbour rank is MPI_PROC_NULL, that half does nothing.
+	MPI_Sendrecv(&temperatures[columns], columns, MPI_DOUBLE, slab->up_neighbour_rank, 0,
+				 &temperatures[(size_t)(slab->rows + 1) * columns], columns, MPI_DOUBLE, slab->down_neighbour_rank, 0, slab->comm, MPI_STATUS_IGNORE);
+
+	// Send my last row down and receive the ghost row above from up.
+	MPI_Sendrecv(&temperatures[(size_t)slab->rows * columns], columns, MPI_DOUBLE, slab->down_neighbour_rank, 1,
+				 &temperatures[0], columns, MPI_DOUBLE, slab->up_neighbour_rank, 1, slab->comm, MPI_STATUS_IGNORE);
+}
+
+void slab_scatter(struct slab* slab, const double* plate, int root)
+{
+	const size_t count = (size_t)slab->rows * slab->columns;
+	MPI_Scatterv(plate, slab->cell_counts, slab->cell_offsets, MPI_DOUBLE, &slab->temperatures_last[slab->columns], (int)count, MPI_DOUBLE, root, slab->comm);
+	memcpy(&slab->temperatures[slab->columns], &slab->temperatures_last[slab->columns], count * sizeof(double));
+
+	// Each row of the mask is first touched by the thread that processes the corresponding row
+	#pragma omp parallel for
+	for(int i = 0; i < slab->rows; i++)
+	{
+		const double* temperatures = &slab->temperatures_last[(size_t)(i + 1) * slab->columns];
+		unsigned char* fixed = &slab->fixed[(size_t)i * slab->columns];
+		for(int j = 0; j < slab->columns; j++)
+		{
+			fixed[j] = temperatures[j] == MAX_TEMPERATURE;
+		}
+	}
+}
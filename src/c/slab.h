@@ -0,0 +1,96 @@
+/**
+ * @file slab.h
+ * @brief Decomposition of the plate into slabs of consecutive rows, one per MPI process.
+ * @details The rows are split as evenly as possible: with R rows and P MPI processes, the first R % P MPI processes get one row more than the others. Every slab holds two buffers of rows + 2 rows laid out as expected by the kernels, ghost rows included.
+ **/
+
+#ifndef SLAB_H_INCLUDED
+#define SLAB_H_INCLUDED
+
+#include <mpi.h>
+
+/**
+ * @brief The part of the plate held by one MPI process.
+ **/
+struct slab
+{
+	/// The communicator across which the plate is decomposed.
+	MPI_Comm comm;
+	/// The rank of this MPI process in comm.
+	int my_rank;
+	/// The number of MPI processes in comm.
+	int comm_size;
+	/// The rank of the MPI process holding the rows above, MPI_PROC_NULL if none.
+	int up_neighbour_rank;
+	/// The rank of the MPI process holding the rows below, MPI_PROC_NULL if none.
+	int down_neighbour_rank;
+	/// The number of rows in the entire plate.
+	int total_rows;
+	/// The number of columns in the entire plate, and in the slab.
+	int columns;
+	/// The number of rows in the slab, ghost rows excluded.
+	int rows;
+	/// The index of the first row of the slab in the plate.
+	int first_global_row;
+	/// On every MPI process: the number of cells in the slab of each MPI process.
+	int* cell_counts;
+	/// On every MPI process: the offset of the first cell of the slab of each MPI process in the plate.
+	int* cell_offsets;
+	/// The temperatures being calculated, (rows + 2) * columns.
+	double* temperatures;
+	/// The temperatures of the previous iteration, (rows + 2) * columns.
+	double* temperatures_last;
+	/// Whether each cell of the slab is a fixed source, rows * columns without ghost rows. Solvers that can overshoot MAX_TEMPERATURE cannot tell sources from their temperature.
+	unsigned char* fixed;
+};
+
+/**
+ * @brief Decomposes a plate and allocates the slab of this MPI process.
+ * @details This is a collective operation. Both buffers are zeroed by the OpenMP threads that will process them, so that their pages are placed close to these threads.
+ * @param[out] slab The slab to initialise.
+ * @param[in] comm The communicator across which the plate is decomposed.
+ * @param[in] total_rows The number of rows in the plate, at least the number of MPI processes.
+ * @param[in] columns The number of columns in the plate.
+ * @return 0 on success, -1 if the plate cannot be decomposed or the memory allocated.
+ **/
+int slab_create(struct slab* slab, MPI_Comm comm, int total_rows, int columns);
+
+/**
+ * @brief Allocates the slab of this MPI process in a plate decomposed unevenly, each MPI process choosing its number of rows.
+ * @details This is a collective operation. The slabs follow each other in the order of the ranks, and the plate has as many rows as all of them together.
+ * @param[out] slab The slab to initialise.
+ * @param[in] comm The communicator across which the plate is decomposed.
+ * @param[in] rows The number of rows of the slab of this MPI process, at least 1.
+ * @param[in] columns The number of columns in the plate.
+ * @return 0 on success, -1 on every MPI process if the plate cannot be decomposed or the memory allocated on one of them.
+ **/
+int slab_create_rows(struct slab* slab, MPI_Comm comm, int rows, int columns);
+
+/**
+ * @brief Releases the memory of a slab.
+ **/
+void slab_destroy(struct slab* slab);
+
+/**
+ * @brief Swaps the two buffers of a slab, so that the temperatures just calculated become the last ones.
+ **/
+void slab_swap(struct slab* slab);
+
+/**
+ * @brief Fills the ghost rows of a buffer with the boundary rows of the neighbouring slabs.
+ * @details This is a collective operation.
+ * @param[in] slab The slab.
+ * @param[in,out] temperatures A buffer of the slab, ghost rows included.
+ **/
+void slab_exchange_ghost_rows(const struct slab* slab, double* temperatures);
+
+/**
+ * @brief Distributes a plate held by one MPI process into both buffers of every slab.
+ * @details This is a collective operation. The cells at MAX_TEMPERATURE in the plate are recorded as fixed.
+ * @param[in,out] slab The slab.
+ * @param[in] plate The entire plate, significant on the root MPI process only.
+ * @param[in] root The rank of the MPI process holding the plate.
+ **/
+void slab_scatter(struct slab* slab, const double* plate, int root);
+
+#endif
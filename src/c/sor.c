@@ -0,0 +1,71 @@
+/**
+ * @file sor.c
+ * @brief Red-black successive over-relaxation.
+ **/
+
+#include <stddef.h>
+#include <math.h>
+
+#include "sor.h"
+
+/**
+ * @brief Relaxes one cell towards the value given by its neighbours and returns its temperature change.
+ **/
+static inline double relax(double* cell, double target, double omega)
+{
+	double change = omega * (target - *cell);
+	*cell += change;
+	return fabs(change);
+}
+
+double sor_sweep(double* restrict temperatures, const unsigned char* restrict fixed, int rows, int columns, int first_global_row, int colour, double omega)
+{
+	double my_temperature_change = 0.0;
+
+	// All cells of a colour depend on cells of the other colour only, so the rows can be processed in any order
+	#pragma omp parallel for reduction(max:my_temperature_change)
+	for(int i = 1; i <= rows; i++)
+	{
+		const double* restrict up = &temperatures[(size_t)(i - 1) * columns];
+		double* restrict current = &temperatures[(size_t)i * columns];
+		const double* restrict down = &temperatures[(size_t)(i + 1) * columns];
+		const unsigned char* restrict my_fixed = &fixed[(size_t)(i - 1) * columns];
+		// The first column of this row that has the colour processed
+		const int first = (first_global_row + i - 1 + colour) & 1;
+		const int last = columns - 1;
+
+		// Process the cell on the left edge, which has no left neighbour
+		if(first == 0 && !my_fixed[0])
+		{
+			my_temperature_change = fmax(relax(&current[0], (up[0] + down[0] + current[1]) / 3.0, omega), my_temperature_change);
+		}
+
+		// Process the cells between the edges, which each has four neighbours
+		#pragma omp simd reduction(max:my_temperature_change)
+		for(int j = (first == 0) ? 2 : 1; j < last; j += 2)
+		{
+			if(!my_fixed[j])
+			{
+				double target = 0.25 * (up[j] + down[j] + current[j - 1] + current[j + 1]);
+				double change = omega * (target - current[j]);
+				current[j] += change;
+				my_temperature_change = fmax(fabs(change), my_temperature_change);
+			}
+		}
+
+		// Process the cell on the right edge, which has no right neighbour
+		if(((last - first) & 1) == 0 && !my_fixed[last])
+		{
+			my_temperature_change = fmax(relax(&current[last], (up[last] + down[last] + current[last - 1]) / 3.0, omega), my_temperature_change);
+		}
+	}
+
+	return my_temperature_change;
+}
+
+double sor_optimal_omega(int total_rows)
+{
+	const double pi = acos(-1.0);
+	double rho = 0.5 * (1.0 + cos(pi / (total_rows + 1)));
+	return 2.0 / (1.0 + sqrt(1.0 - rho * rho));
+}
@@ -0,0 +1,37 @@
+/**
+ * @file sor.h
+ * @brief Red-black successive over-relaxation, an alternative to the Jacobi iteration when only the steady state matters.
+ * @details The cells are coloured like a chessboard: a cell is red if the sum of its row and column in the plate is even, black otherwise. Every neighbour of a red cell is black and vice versa, including the three neighbours of cells on the left and right edges, so all cells of a colour can be updated in place and in parallel from the cells of the other colour. An iteration updates the red cells, then the black cells, the ghost rows being exchanged before each colour.
+ * Each cell moves from its temperature t towards the Jacobi value j of its neighbours by t + omega * (j - t): omega = 1 is Gauss-Seidel, 1 < omega < 2 over-relaxes.
+ **/
+
+#ifndef SOR_H_INCLUDED
+#define SOR_H_INCLUDED
+
+/// The colour of the cells whose row and column in the plate add up to an even number.
+#define SOR_RED 0
+/// The colour of the cells whose row and column in the plate add up to an odd number.
+#define SOR_BLACK 1
+
+/**
+ * @brief Updates the cells of one colour in place.
+ * @param[in,out] temperatures The temperatures of the slab, ghost rows included and up to date.
+ * @param[in] fixed Whether each cell of the slab is a fixed source, rows * columns without ghost rows.
+ * @param[in] rows The number of rows in the slab, ghost rows excluded.
+ * @param[in] columns The number of columns, at least 2.
+ * @param[in] first_global_row The index of the first row of the slab in the plate, which tells the colour of the cells.
+ * @param[in] colour SOR_RED or SOR_BLACK.
+ * @param[in] omega The relaxation factor, in ]0, 2[.
+ * @return The maximum absolute temperature change of the cells updated.
+ **/
+double sor_sweep(double* restrict temperatures, const unsigned char* restrict fixed, int rows, int columns, int first_global_row, int colour, double omega);
+
+/**
+ * @brief Calculates the relaxation factor that minimises the spectral radius of the iteration on this plate.
+ * @details The plate is held at 0 above and below, and insulated on the left and right edges; the Jacobi iteration therefore converges at rate rho = (1 + cos(pi / (rows + 1))) / 2, for which the optimal factor is 2 / (1 + sqrt(1 - rho^2)).
+ * @param[in] total_rows The number of rows in the plate.
+ * @return The optimal relaxation factor.
+ **/
+double sor_optimal_omega(int total_rows);
+
+#endif
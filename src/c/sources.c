@@ -0,0 +1,773 @@
+/**
+ * @file sources.c
+ * @brief Heat sources described in a file rather than hard-coded.
+ **/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <errno.h>
+#include <math.h>
+
+#include "sources.h"
+
+/// The most words a line of a source file can have.
+#define MAX_WORDS 1024
+
+/**
+ * @brief Parses a whole word as an integer.
+ * @return 0 on success, -1 if the word is not an integer.
+ **/
+static int parse_int(const char* word, int* value)
+{
+	char* end;
+	errno = 0;
+	const long parsed = strtol(word, &end, 10);
+	if(*word == '\0' || *end != '\0' || errno != 0 || parsed < INT_MIN || parsed > INT_MAX)
+	{
+		return -1;
+	}
+	*value = (int)parsed;
+	return 0;
+}
+
+/**
+ * @brief Parses a whole word as a finite number.
+ * @return 0 on success, -1 if the word is not a finite number.
+ **/
+static int parse_double(const char* word, double* value)
+{
+	char* end;
+	*value = strtod(word, &end);
+	return (*word == '\0' || *end != '\0' || !isfinite(*value)) ? -1 : 0;
+}
+
+/**
+ * @brief Parses the schedule keywords at the end of a line into a source.
+ * @return 0 on success, -1 if a keyword is not understood.
+ **/
+static int parse_schedule(char* words[], int count, struct source* source)
+{
+	for(int k = 0; k < count; )
+	{
+		if(strcmp(words[k], "from") == 0 && k + 1 < count && parse_int(words[k + 1], &source->from) == 0 && source->from >= 0)
+		{
+			k += 2;
+		}
+		else if(strcmp(words[k], "until") == 0 && k + 1 < count && parse_int(words[k + 1], &source->until) == 0)
+		{
+			k += 2;
+		}
+		else if(strcmp(words[k], "move") == 0 && k + 3 < count && parse_int(words[k + 1], &source->move_rows) == 0 && parse_int(words[k + 2], &source->move_columns) == 0 && parse_int(words[k + 3], &source->move_every) == 0 && source->move_every > 0)
+		{
+			k += 4;
+		}
+		else
+		{
+			return -1;
+		}
+	}
+	return 0;
+}
+
+/**
+ * @brief Adds a source, growing the list as needed.
+ * @return 0 on success, -1 if the memory cannot be allocated.
+ **/
+static int add_source(struct sources* sources, int* capacity, const struct source* source)
+{
+	if(sources->count == *capacity)
+	{
+		*capacity = *capacity ? *capacity * 2 : 64;
+		struct source* list = realloc(sources->list, *capacity * sizeof(struct source));
+		if(list == NULL)
+		{
+			return -1;
+		}
+		sources->list = list;
+	}
+	sources->list[sources->count++] = *source;
+	return 0;
+}
+
+/**
+ * @brief Parses a line of a source file, made of words, into one source or more.
+ * @return 0 on success, -1 if the line is not understood, -2 if the memory cannot be allocated.
+ **/
+static int parse_line(char* words[], int count, struct sources* sources, int* capacity)
+{
+	struct source source;
+	memset(&source, 0, sizeof(source));
+	source.until = INT_MAX;
+	if(count < 2 || parse_double(words[1], &source.temperature) != 0)
+	{
+		return -1;
+	}
+
+	// The parameters of the shape, then its schedule
+	int parameters[4];
+	int parameter_count = (strcmp(words[0], "disc") == 0) ? 3 : (strcmp(words[0], "points") == 0) ? 2 : 4;
+	if(strcmp(words[0], "rectangle") == 0 || strcmp(words[0], "line") == 0 || strcmp(words[0], "disc") == 0)
+	{
+		for(int k = 0; k < parameter_count; k++)
+		{
+			if(2 + k >= count || parse_int(words[2 + k], &parameters[k]) != 0)
+			{
+				return -1;
+			}
+		}
+		if(parse_schedule(&words[2 + parameter_count], count - 2 - parameter_count, &source) != 0)
+		{
+			return -1;
+		}
+		source.row0 = parameters[0];
+		source.column0 = parameters[1];
+		if(words[0][0] == 'd')
+		{
+			source.shape = SOURCE_DISC;
+			source.radius = parameters[2];
+			if(source.radius < 0)
+			{
+				return -1;
+			}
+		}
+		else
+		{
+			source.shape = (words[0][0] == 'r') ? SOURCE_RECTANGLE : SOURCE_LINE;
+			source.row1 = parameters[2];
+			source.column1 = parameters[3];
+		}
+		return (add_source(sources, capacity, &source) == 0) ? 0 : -2;
+	}
+	else if(strcmp(words[0], "points") == 0)
+	{
+		// The points go on as long as the words are pairs of numbers; they share the schedule that follows
+		int end = 2;
+		while(end + 1 < count && parse_int(words[end], &parameters[0]) == 0 && parse_int(words[end + 1], &parameters[1]) == 0)
+		{
+			end += 2;
+		}
+		if(end == 2 || parse_schedule(&words[end], count - end, &source) != 0)
+		{
+			return -1;
+		}
+		source.shape = SOURCE_POINT;
+		for(int k = 2; k < end; k += 2)
+		{
+			parse_int(words[k], &source.row0);
+			parse_int(words[k + 1], &source.column0);
+			if(add_source(sources, capacity, &source) != 0)
+			{
+				return -2;
+			}
+		}
+		return 0;
+	}
+	return -1;
+}
+
+int sources_load(struct sources* sources, const char* path)
+{
+	memset(sources, 0, sizeof(*sources));
+	FILE* file = fopen(path, "r");
+	if(file == NULL)
+	{
+		fprintf(stderr, "Cannot read the sources \"%s\".\n", path);
+		return -1;
+	}
+
+	int capacity = 0;
+	int line_number = 0;
+	char line[8192];
+	int status = 0;
+	while(status == 0 && fgets(line, sizeof(line), file) != NULL)
+	{
+		line_number++;
+		char* words[MAX_WORDS];
+		int count = 0;
+		for(char* word = strtok(line, " \t\r\n"); word != NULL && count < MAX_WORDS; word = strtok(NULL, " \t\r\n"))
+		{
+			words[count++] = word;
+		}
+		if(count == 0 || words[0][0] == '#')
+		{
+			continue;
+		}
+		status = parse_line(words, count, sources, &capacity);
+		if(status == -1)
+		{
+			fprintf(stderr, "%s:%d: cannot understand the %s.\n", path, line_number, words[0]);
+		}
+		else if(status == -2)
+		{
+			fprintf(stderr, "%s:%d: cannot allocate the sources.\n", path, line_number);
+		}
+	}
+	fclose(file);
+	if(status != 0)
+	{
+		sources_free(sources);
+		return -1;
+	}
+	return 0;
+}
+
+void sources_free(struct sources* sources)
+{
+	free(sources->list);
+	memset(sources, 0, sizeof(*sources));
+}
+
+int sources_scheduled(const struct sources* sources)
+{
+	for(int s = 0; s < sources->count; s++)
+	{
+		const struct source* source = &sources->list[s];
+		if(source->from > 0 || source->until != INT_MAX || source->move_every > 0)
+		{
+			return 1;
+		}
+	}
+	return 0;
+}
+
+/**
+ * @brief Places a source where it is at an iteration.
+ * @param[out] placed The source, moved as it is at that iteration.
+ * @return 1 if the source is on at that iteration, 0 otherwise.
+ **/
+static int source_at(const struct source* source, int iteration, struct source* placed)
+{
+	*placed = *source;
+	if(iteration < source->from || iteration >= source->until)
+	{
+		return 0;
+	}
+	if(source->move_every > 0)
+	{
+		const int moves = (iteration - source->from) / source->move_every;
+		placed->row0 += moves * source->move_rows;
+		placed->row1 += moves * source->move_rows;
+		placed->column0 += moves * source->move_columns;
+		placed->column1 += moves * source->move_columns;
+	}
+	return 1;
+}
+
+/**
+ * @brief Returns the first iteration after a given one at which a source switches or moves, INT_MAX if none.
+ **/
+static int next_change(const struct source* source, int iteration)
+{
+	if(iteration < source->from)
+	{
+		return source->from;
+	}
+	if(iteration >= source->until)
+	{
+		return INT_MAX;
+	}
+	long long change = source->until;
+	if(source->move_every > 0)
+	{
+		const long long next_move = source->from + ((long long)(iteration - source->from) / source->move_every + 1) * source->move_every;
+		change = (next_move < change) ? next_move : change;
+	}
+	return (change > INT_MAX) ? INT_MAX : (int)change;
+}
+
+/**
+ * @brief Returns the first and last rows a placed source covers.
+ **/
+static void source_rows(const struct source* source, int* top, int* bottom)
+{
+	switch(source->shape)
+	{
+		case SOURCE_RECTANGLE:
+		case SOURCE_LINE:
+			*top = (source->row0 < source->row1) ? source->row0 : source->row1;
+			*bottom = (source->row0 < source->row1) ? source->row1 : source->row0;
+			break;
+		case SOURCE_DISC:
+			*top = source->row0 - source->radius;
+			*bottom = source->row0 + source->radius;
+			break;
+		case SOURCE_POINT:
+			*top = source->row0;
+			*bottom = source->row0;
+			break;
+	}
+}
+
+/**
+ * @brief The cells of a source on a row: columns begin to end excluded, at a temperature.
+ **/
+struct interval
+{
+	int begin;
+	int end;
+	double temperature;
+};
+
+/**
+ * @brief The intervals of the sources on every row of a range, in the order of the sources: the spatial index from which the spans are built.
+ **/
+struct interval_index
+{
+	/// The first row of the range in the plate.
+	int first_row;
+	/// The number of rows in the range.
+	int rows;
+	/// The number of columns in the plate.
+	int columns;
+	/// The number of intervals of every row while counting, then the offset of the next interval of every row while filling.
+	int* row_counts;
+	/// The intervals, one row after the other; NULL while counting.
+	struct interval* intervals;
+};
+
+/**
+ * @brief Counts an interval or stores it, depending on the pass; clips it to the plate first.
+ **/
+static void add_interval(struct interval_index* index, int row, int begin, int end, double temperature)
+{
+	const int local_row = row - index->first_row;
+	begin = (begin < 0) ? 0 : begin;
+	end = (end > index->columns) ? index->columns : end;
+	if(local_row < 0 || local_row >= index->rows || begin >= end)
+	{
+		return;
+	}
+	if(index->intervals == NULL)
+	{
+		index->row_counts[local_row]++;
+	}
+	else
+	{
+		struct interval* interval = &index->intervals[index->row_counts[local_row]++];
+		interval->begin = begin;
+		interval->end = end;
+		interval->temperature = temperature;
+	}
+}
+
+/**
+ * @brief Adds the intervals of a placed source on the rows of the range.
+ **/
+static void add_source_intervals(struct interval_index* index, const struct source* source)
+{
+	int top;
+	int bottom;
+	source_rows(source, &top, &bottom);
+	const int first_row = (top > index->first_row) ? top : index->first_row;
+	const int last_row = (bottom < index->first_row + index->rows - 1) ? bottom : index->first_row + index->rows - 1;
+	switch(source->shape)
+	{
+		case SOURCE_RECTANGLE:
+		{
+			const int left = (source->column0 < source->column1) ? source->column0 : source->column1;
+			const int right = (source->column0 < source->column1) ? source->column1 : source->column0;
+			for(int row = first_row; row <= last_row; row++)
+			{
+				add_interval(index, row, left, right + 1, source->temperature);
+			}
+			break;
+		}
+		case SOURCE_DISC:
+		{
+			for(int row = first_row; row <= last_row; row++)
+			{
+				const double dy = row - source->row0;
+				const int half_width = (int)floor(sqrt((double)source->radius * source->radius - dy * dy));
+				add_interval(index, row, source->column0 - half_width, source->column0 + half_width + 1, source->temperature);
+			}
+			break;
+		}
+		case SOURCE_LINE:
+		{
+			if(first_row > last_row)
+			{
+				break;
+			}
+			const int row_delta = source->row1 - source->row0;
+			const int column_delta = source->column1 - source->column0;
+			const int steps = (abs(row_delta) > abs(column_delta)) ? abs(row_delta) : abs(column_delta);
+			for(int k = 0; k <= steps; k++)
+			{
+				const int row = source->row0 + (steps ? (int)lround((double)k * row_delta / steps) : 0);
+				const int column = source->column0 + (steps ? (int)lround((double)k * column_delta / steps) : 0);
+				add_interval(index, row, column, column + 1, source->temperature);
+			}
+			break;
+		}
+		case SOURCE_POINT:
+			add_interval(index, source->row0, source->column0, source->column0 + 1, source->temperature);
+			break;
+	}
+}
+
+/**
+ * @brief Builds the spans of a range of rows from the sources as they are at an iteration.
+ * @param[out] row_counts The number of spans of every row of the range.
+ * @param[out] spans The spans of every row, one row after the other, allocated.
+ * @return 0 on success, -1 if the memory cannot be allocated.
+ **/
+static int build_spans(const struct sources* sources, int iteration, int first_row, int rows, int columns, int* row_counts, struct source_span** spans)
+{
+	*spans = NULL;
+
+	// The index is built in two passes, counting the intervals of every row then storing them
+	struct interval_index index = {first_row, rows, columns, calloc(rows + 1, sizeof(int)), NULL};
+	double* row_temperatures = malloc(columns * sizeof(double));
+	unsigned char* row_sources = malloc(columns);
+	int status = (index.row_counts != NULL && row_temperatures != NULL && row_sources != NULL) ? 0 : -1;
+	for(int pass = 0; pass < 2 && status == 0; pass++)
+	{
+		for(int s = 0; s < sources->count; s++)
+		{
+			struct source placed;
+			if(source_at(&sources->list[s], iteration, &placed))
+			{
+				add_source_intervals(&index, &placed);
+			}
+		}
+		if(pass == 0)
+		{
+			int total = 0;
+			for(int i = 0; i <= rows; i++)
+			{
+				const int count = index.row_counts[i];
+				index.row_counts[i] = total;
+				total += count;
+			}
+			index.intervals = malloc((total > 0 ? total : 1) * sizeof(struct interval));
+			status = (index.intervals != NULL) ? 0 : -1;
+		}
+	}
+
+	// Every row is painted in the order of the sources, then cut into runs of source cells at the same temperature
+	int capacity = 0;
+	int count = 0;
+	int first_interval = 0;
+	for(int i = 0; status == 0 && i < rows; i++)
+	{
+		const int row_start = count;
+		const int last_interval = index.row_counts[i];
+		if(first_interval == last_interval)
+		{
+			row_counts[i] = 0;
+			continue;
+		}
+		memset(row_sources, 0, columns);
+		for(int k = first_interval; k < last_interval; k++)
+		{
+			for(int j = index.intervals[k].begin; j < index.intervals[k].end; j++)
+			{
+				row_sources[j] = 1;
+				row_temperatures[j] = index.intervals[k].temperature;
+			}
+		}
+		first_interval = last_interval;
+		for(int j = 0; status == 0 && j < columns; )
+		{
+			if(!row_sources[j])
+			{
+				j++;
+				continue;
+			}
+			int end = j + 1;
+			while(end < columns && row_sources[end] && row_temperatures[end] == row_temperatures[j])
+			{
+				end++;
+			}
+			if(count == capacity)
+			{
+				capacity = capacity ? capacity * 2 : 1024;
+				struct source_span* grown = realloc(*spans, capacity * sizeof(struct source_span));
+				if(grown == NULL)
+				{
+					status = -1;
+					break;
+				}
+				*spans = grown;
+			}
+			(*spans)[count].begin = j;
+			(*spans)[count].end = end;
+			(*spans)[count].temperature = row_temperatures[j];
+			count++;
+			j = end;
+		}
+		row_counts[i] = count - row_start;
+	}
+
+	free(index.row_counts);
+	free(index.intervals);
+	free(row_temperatures);
+	free(row_sources);
+	if(status != 0)
+	{
+		free(*spans);
+		*spans = NULL;
+	}
+	return status;
+}
+
+/**
+ * @brief Returns the first iteration after a given one at which any source switches or moves, INT_MAX if none.
+ **/
+static int sources_next_change(const struct sources* sources, int iteration)
+{
+	int change = INT_MAX;
+	for(int s = 0; s < sources->count; s++)
+	{
+		const int source_change = next_change(&sources->list[s], iteration);
+		change = (source_change < change) ? source_change : change;
+	}
+	return change;
+}
+
+int sources_compile(const struct sources* sources, struct source_spans* spans, int first_row, int rows, int columns, int iteration)
+{
+	memset(spans, 0, sizeof(*spans));
+	spans->first_row = first_row;
+	spans->rows = rows;
+	spans->columns = columns;
+	spans->row_offsets = malloc((rows + 1) * sizeof(int));
+	spans->row_counts = malloc((rows > 0 ? rows : 1) * sizeof(int));
+	if(spans->row_offsets == NULL || spans->row_counts == NULL || build_spans(sources, iteration, first_row, rows, columns, spans->row_counts, &spans->spans) != 0)
+	{
+		sources_spans_free(spans);
+		return -1;
+	}
+
+	// Every row starts with exactly the slots it needs; the first to need more gets its own room
+	spans->row_offsets[0] = 0;
+	for(int i = 0; i < rows; i++)
+	{
+		spans->row_offsets[i + 1] = spans->row_offsets[i] + spans->row_counts[i];
+	}
+	spans->next_change = sources_next_change(sources, iteration);
+	return 0;
+}
+
+/**
+ * @brief Gives a row of the spans room for a number of spans, moving the slots of every row if needed.
+ * @return 0 on success, -1 if the memory cannot be allocated.
+ **/
+static int reserve_row(struct source_spans* spans, int row, int count)
+{
+	if(spans->row_offsets[row + 1] - spans->row_offsets[row] >= count)
+	{
+		return 0;
+	}
+
+	// The row gets twice the room it needs so that a source going back and forth does not move the slots every time
+	int* row_offsets = malloc((spans->rows + 1) * sizeof(int));
+	if(row_offsets == NULL)
+	{
+		return -1;
+	}
+	row_offsets[0] = 0;
+	for(int i = 0; i < spans->rows; i++)
+	{
+		const int slots = (i == row) ? 2 * count : spans->row_offsets[i + 1] - spans->row_offsets[i];
+		row_offsets[i + 1] = row_offsets[i] + slots;
+	}
+	struct source_span* moved = malloc((row_offsets[spans->rows] > 0 ? row_offsets[spans->rows] : 1) * sizeof(struct source_span));
+	if(moved == NULL)
+	{
+		free(row_offsets);
+		free(moved);
+		return -1;
+	}
+	for(int i = 0; i < spans->rows; i++)
+	{
+		memcpy(&moved[row_offsets[i]], &spans->spans[spans->row_offsets[i]], spans->row_counts[i] * sizeof(struct source_span));
+	}
+	free(spans->row_offsets);
+	free(spans->spans);
+	spans->row_offsets = row_offsets;
+	spans->spans = moved;
+	return 0;
+}
+
+int sources_update(const struct sources* sources, struct source_spans* spans, int iteration, double* temperatures_last, double* temperatures, unsigned char* fixed)
+{
+	if(iteration < spans->next_change)
+	{
+		return 0;
+	}
+
+	// The rows to compile again are those a source leaves or enters
+	unsigned char* changed_rows = calloc(spans->rows > 0 ? spans->rows : 1, 1);
+	if(changed_rows == NULL)
+	{
+		return -1;
+	}
+	for(int s = 0; s < sources->count; s++)
+	{
+		struct source before;
+		struct source after;
+		const int on_before = source_at(&sources->list[s], iteration - 1, &before);
+		const int on_after = source_at(&sources->list[s], iteration, &after);
+		if(on_before == on_after && (!on_after || (before.row0 == after.row0 && before.column0 == after.column0)))
+		{
+			continue;
+		}
+		const struct source* placements[2] = {on_before ? &before : NULL, on_after ? &after : NULL};
+		for(int p = 0; p < 2; p++)
+		{
+			if(placements[p] == NULL)
+			{
+				continue;
+			}
+			int top;
+			int bottom;
+			source_rows(placements[p], &top, &bottom);
+			top = (top > spans->first_row) ? top - spans->first_row : 0;
+			bottom = (bottom < spans->first_row + spans->rows - 1) ? bottom - spans->first_row : spans->rows - 1;
+			for(int i = top; i <= bottom; i++)
+			{
+				changed_rows[i] = 1;
+			}
+		}
+	}
+
+	int compiled_rows = 0;
+	const int columns = spans->columns;
+	for(int i = 0; i < spans->rows; i++)
+	{
+		if(!changed_rows[i])
+		{
+			continue;
+		}
+		int count;
+		struct source_span* row_spans;
+		if(build_spans(sources, iteration, spans->first_row + i, 1, columns, &count, &row_spans) != 0 || reserve_row(spans, i, count) != 0)
+		{
+			free(changed_rows);
+			return -1;
+		}
+
+		// The cells of the old spans are released, then those of the new ones fixed at their temperature
+		unsigned char* row_fixed = &fixed[(size_t)i * columns];
+		struct source_span* old_spans = &spans->spans[spans->row_offsets[i]];
+		for(int s = 0; s < spans->row_counts[i]; s++)
+		{
+			memset(&row_fixed[old_spans[s].begin], 0, old_spans[s].end - old_spans[s].begin);
+		}
+		for(int s = 0; s < count; s++)
+		{
+			old_spans[s] = row_spans[s];
+			memset(&row_fixed[row_spans[s].begin], 1, row_spans[s].end - row_spans[s].begin);
+			for(int j = row_spans[s].begin; j < row_spans[s].end; j++)
+			{
+				temperatures_last[(size_t)i * columns + j] = row_spans[s].temperature;
+				temperatures[(size_t)i * columns + j] = row_spans[s].temperature;
+			}
+		}
+		spans->row_counts[i] = count;
+		free(row_spans);
+		compiled_rows++;
+	}
+	free(changed_rows);
+	spans->next_change = sources_next_change(sources, iteration);
+	return compiled_rows;
+}
+
+void sources_spans_free(struct source_spans* spans)
+{
+	free(spans->row_offsets);
+	free(spans->row_counts);
+	free(spans->spans);
+	memset(spans, 0, sizeof(*spans));
+}
+
+void sources_paint(const struct source_spans* spans, double* temperatures, int columns)
+{
+	for(int i = 0; i < spans->rows; i++)
+	{
+		const struct source_span* row_spans = &spans->spans[spans->row_offsets[i]];
+		for(int s = 0; s < spans->row_counts[i]; s++)
+		{
+			for(int j = row_spans[s].begin; j < row_spans[s].end; j++)
+			{
+				temperatures[(size_t)i * columns + j] = row_spans[s].temperature;
+			}
+		}
+	}
+}
+
+void sources_mark(const struct source_spans* spans, unsigned char* fixed, int columns)
+{
+	#pragma omp parallel for
+	for(int i = 0; i < spans->rows; i++)
+	{
+		memset(&fixed[(size_t)i * columns], 0, columns);
+		const struct source_span* row_spans = &spans->spans[spans->row_offsets[i]];
+		for(int s = 0; s < spans->row_counts[i]; s++)
+		{
+			memset(&fixed[(size_t)i * columns + row_spans[s].begin], 1, row_spans[s].end - row_spans[s].begin);
+		}
+	}
+}
+
+/**
+ * @brief Propagates the cells of a row between two columns, none of which is a source, and returns their maximum temperature change.
+ **/
+static inline double propagate_segment(const double* restrict before, const double* restrict last, const double* restrict after, double* restrict current, int begin, int end, int columns)
+{
+	double change = 0.0;
+	int j = begin;
+	if(j == 0 && j < end)
+	{
+		current[0] = (before[0] + after[0] + last[1]) / 3.0;
+		change = fabs(current[0] - last[0]);
+		j++;
+	}
+	const int inner_end = (end < columns - 1) ? end : columns - 1;
+	#pragma omp simd reduction(max:change)
+	for(int k = j; k < inner_end; k++)
+	{
+		current[k] = 0.25 * (before[k] + after[k] + last[k - 1] + last[k + 1]);
+		change = fmax(fabs(current[k] - last[k]), change);
+	}
+	if(end == columns && j <= columns - 1)
+	{
+		const int k = columns - 1;
+		current[k] = (before[k] + after[k] + last[k - 1]) / 3.0;
+		change = fmax(fabs(current[k] - last[k]), change);
+	}
+	return change;
+}
+
+double sources_propagate(const double* restrict temperatures_last, double* restrict temperatures, int rows, int columns, const struct source_spans* spans)
+{
+	double my_temperature_change = 0.0;
+
+	#pragma omp parallel for reduction(max:my_temperature_change)
+	for(int i = 1; i <= rows; i++)
+	{
+		const double* restrict before = &temperatures_last[(size_t)(i - 1) * columns];
+		const double* restrict last = &temperatures_last[(size_t)i * columns];
+		const double* restrict after = &temperatures_last[(size_t)(i + 1) * columns];
+		double* restrict current = &temperatures[(size_t)i * columns];
+
+		// The cells between spans are updated, the spans keep their temperature
+		const struct source_span* row_spans = &spans->spans[spans->row_offsets[i - 1]];
+		int j = 0;
+		for(int s = 0; s < spans->row_counts[i - 1]; s++)
+		{
+			my_temperature_change = fmax(propagate_segment(before, last, after, current, j, row_spans[s].begin, columns), my_temperature_change);
+			for(int k = row_spans[s].begin; k < row_spans[s].end; k++)
+			{
+				current[k] = row_spans[s].temperature;
+			}
+			j = row_spans[s].end;
+		}
+		my_temperature_change = fmax(propagate_segment(before, last, after, current, j, columns, columns), my_temperature_change);
+	}
+
+	return my_temperature_change;
+}
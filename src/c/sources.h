@@ -0,0 +1,178 @@
+/**
+ * @file sources.h
+ * @brief Heat sources described in a file rather than hard-coded, see --sources.
+ * @details A source file has one source per line; blank lines and lines starting with '#' are ignored. Coordinates are rows and columns of the plate, counted from 0, and every source has its own temperature:
+ * - "rectangle TEMPERATURE ROW0 COLUMN0 ROW1 COLUMN1": the cells between both corners, included;
+ * - "disc TEMPERATURE ROW COLUMN RADIUS": the cells whose distance to the centre is at most the radius;
+ * - "line TEMPERATURE ROW0 COLUMN0 ROW1 COLUMN1": the cells of the segment between both ends, one per step along its longer axis;
+ * - "points TEMPERATURE ROW COLUMN [ROW COLUMN]...": individual cells.
+ * Sources may extend beyond the plate, which clips them; where sources overlap, the last one in the file wins.
+ * A source may follow a schedule, given by keywords after its parameters, in any order:
+ * - "from ITERATION": the source switches on at that iteration instead of at the start;
+ * - "until ITERATION": the source switches off at that iteration; its cells then cool down like any other;
+ * - "move ROWS COLUMNS EVERY": every EVERY iterations after it switched on, the source moves by ROWS rows and COLUMNS columns.
+ * Each MPI process compiles the sources into a span table: for every one of its rows, the runs of consecutive source cells at the same temperature, in increasing order of column. The kernel walks the spans of a row instead of comparing every cell with MAX_TEMPERATURE, so a source layout costs nothing per iteration beyond its spans. When a source switches or moves, only the rows it leaves and enters are compiled again, and only their fixed cells and temperatures are updated.
+ **/
+
+#ifndef SOURCES_H_INCLUDED
+#define SOURCES_H_INCLUDED
+
+/**
+ * @brief The shapes a source can have.
+ **/
+enum source_shape
+{
+	SOURCE_RECTANGLE,
+	SOURCE_DISC,
+	SOURCE_LINE,
+	SOURCE_POINT
+};
+
+/**
+ * @brief A source, as described in the file; a list of points is one source per point.
+ **/
+struct source
+{
+	/// The shape of the source.
+	enum source_shape shape;
+	/// The temperature of its cells.
+	double temperature;
+	/// The first corner, end, centre or point.
+	int row0;
+	int column0;
+	/// The second corner or end; unused for discs and points.
+	int row1;
+	int column1;
+	/// The radius of a disc.
+	int radius;
+	/// The iteration at which the source switches on.
+	int from;
+	/// The iteration at which the source switches off, INT_MAX if never.
+	int until;
+	/// The number of iterations between two moves, 0 if the source does not move.
+	int move_every;
+	/// The rows and columns by which the source moves every time.
+	int move_rows;
+	int move_columns;
+};
+
+/**
+ * @brief The sources of a file.
+ **/
+struct sources
+{
+	/// The sources, in the order of the file.
+	struct source* list;
+	/// The number of sources.
+	int count;
+};
+
+/**
+ * @brief A run of consecutive source cells at the same temperature on a row.
+ **/
+struct source_span
+{
+	/// The first column of the run.
+	int begin;
+	/// The column after the last one of the run.
+	int end;
+	/// The temperature of its cells.
+	double temperature;
+};
+
+/**
+ * @brief The spans of a range of rows, stored like a compressed sparse row matrix with room for every row to grow.
+ **/
+struct source_spans
+{
+	/// The index of the first row of the range in the plate.
+	int first_row;
+	/// The number of rows.
+	int rows;
+	/// The number of columns of the plate.
+	int columns;
+	/// The slots of row i are spans[row_offsets[i]] to spans[row_offsets[i + 1]] excluded; rows + 1 entries.
+	int* row_offsets;
+	/// The number of slots of every row holding a span, from the first one.
+	int* row_counts;
+	/// The spans of every row, one row after the other.
+	struct source_span* spans;
+	/// The iteration at which the spans change next, INT_MAX if never.
+	int next_change;
+};
+
+/**
+ * @brief Reads the sources of a file.
+ * @param[out] sources The sources.
+ * @param[in] path The path of the file.
+ * @return 0 on success, -1 if the file cannot be read or a line is not understood, in which case a message has been printed on stderr.
+ **/
+int sources_load(struct sources* sources, const char* path);
+
+/**
+ * @brief Releases the memory of sources.
+ **/
+void sources_free(struct sources* sources);
+
+/**
+ * @brief Tells whether any source follows a schedule.
+ **/
+int sources_scheduled(const struct sources* sources);
+
+/**
+ * @brief Compiles the sources into the spans of a range of rows, as they are at an iteration.
+ * @param[in] sources The sources.
+ * @param[out] spans The spans.
+ * @param[in] first_row The index of the first row of the range in the plate.
+ * @param[in] rows The number of rows in the range.
+ * @param[in] columns The number of columns of the plate.
+ * @param[in] iteration The iteration.
+ * @return 0 on success, -1 if the memory cannot be allocated.
+ **/
+int sources_compile(const struct sources* sources, struct source_spans* spans, int first_row, int rows, int columns, int iteration);
+
+/**
+ * @brief Brings the spans, fixed cells and temperatures of a range of rows to an iteration, from the iteration before.
+ * @details Returns at once unless a source switches or moves at that iteration; otherwise only the rows such a source leaves or enters are compiled again. Cells entering a source take its temperature in both buffers, cells leaving one keep theirs.
+ * @param[in] sources The sources.
+ * @param[in,out] spans The spans, compiled at the iteration before.
+ * @param[in] iteration The iteration.
+ * @param[in,out] temperatures_last The first row of the range in the temperatures at the previous iteration.
+ * @param[in,out] temperatures The first row of the range in the other buffer.
+ * @param[in,out] fixed The fixed cells of the rows.
+ * @return The number of rows compiled again, or -1 if the memory cannot be allocated.
+ **/
+int sources_update(const struct sources* sources, struct source_spans* spans, int iteration, double* temperatures_last, double* temperatures, unsigned char* fixed);
+
+/**
+ * @brief Releases the memory of spans.
+ **/
+void sources_spans_free(struct source_spans* spans);
+
+/**
+ * @brief Writes the temperatures of the sources into their cells; the other cells are not written.
+ * @param[in] spans The spans of the rows.
+ * @param[in,out] temperatures The rows, spans->rows * columns in row-major order.
+ **/
+void sources_paint(const struct source_spans* spans, double* temperatures, int columns);
+
+/**
+ * @brief Builds the fixed cells of the rows: 1 in the spans, 0 elsewhere.
+ * @param[in] spans The spans of the rows.
+ * @param[out] fixed The fixed cells, spans->rows * columns in row-major order.
+ **/
+void sources_mark(const struct source_spans* spans, unsigned char* fixed, int columns);
+
+/**
+ * @brief Propagates the temperatures of a C slab by one iteration like heat_propagate, with the sources given by spans instead of MAX_TEMPERATURE.
+ * @details The cells outside the spans are updated in the order of heat_propagate, so a file describing the sources of the dataset gives bit for bit the same results.
+ * @param[in] temperatures_last The temperatures at the previous iteration, ghost rows included.
+ * @param[out] temperatures The temperatures at this iteration; ghost rows are not written.
+ * @param[in] rows The number of rows in the slab, ghost rows excluded, that of the spans.
+ * @param[in] columns The number of columns, at least 2.
+ * @param[in] spans The spans of the slab.
+ * @return The maximum absolute temperature change in the slab.
+ **/
+double sources_propagate(const double* restrict temperatures_last, double* restrict temperatures, int rows, int columns, const struct source_spans* spans);
+
+#endif
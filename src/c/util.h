@@ -11,36 +11,45 @@
 
 #define SNAPSHOT_INTERVAL 25
 
-void initialise_temperatures(double temperatures[ROWS][COLUMNS])
+/**
+ * @brief Initialises a plate of any size with the flame of the dataset: a square in the middle for BIG, every 100th column for SMALL.
+ * @param[out] temperatures The plate, rows * columns in row-major order.
+ **/
+void initialise_plate(double* temperatures, int rows, int columns)
 {
 	#ifdef BIG
-		int MID_ROWS = ROWS/2;
-		int MID_COLUMNS = COLUMNS/2;
-		int THICKNESS = ROWS / 2;
-		for(int i = 0; i < ROWS; i++)
+		int MID_ROWS = rows/2;
+		int MID_COLUMNS = columns/2;
+		int THICKNESS = rows / 2;
+		for(int i = 0; i < rows; i++)
 		{
-			for(int j = 0; j < COLUMNS; j++)
+			for(int j = 0; j < columns; j++)
 			{
 				if(i >= (MID_ROWS - THICKNESS/2) && i <= (MID_ROWS + THICKNESS/2) &&
 				   j >= (MID_COLUMNS - THICKNESS/2) && j <= (MID_COLUMNS + THICKNESS/2))
 				{
-					temperatures[i][j] = MAX_TEMPERATURE;
+					temperatures[(size_t)i * columns + j] = MAX_TEMPERATURE;
 				}
 				else
 				{
-					temperatures[i][j] = 0.0;
+					temperatures[(size_t)i * columns + j] = 0.0;
 				}
 			}
 		}
 	#else
-		for(int i = 0; i < ROWS; i++)
+		for(int i = 0; i < rows; i++)
 		{
-			for(int j = 0; j < COLUMNS; j++)
+			for(int j = 0; j < columns; j++)
 			{
-				temperatures[i][j] = (j % 100 == 0) ? MAX_TEMPERATURE : 0.0;
+				temperatures[(size_t)i * columns + j] = (j % 100 == 0) ? MAX_TEMPERATURE : 0.0;
 			}
 		}
 	#endif
 }
 
+void initialise_temperatures(double temperatures[ROWS][COLUMNS])
+{
+	initialise_plate(&temperatures[0][0], ROWS, COLUMNS);
+}
+
 #endif
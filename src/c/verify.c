@@ -0,0 +1,343 @@
+/**
+ * @file verify.c
+ * @brief Compares the output of a run, and optionally the field it dumped, against references.
+ * @details The output is the text printed by the program: "Iteration N: CHANGE" lines, and "Hash N: HASH" lines when run with --hash. Every such line whose iteration is also found in a reference is compared exactly; the temperature changes are compared as printed, to the 18th decimal, and the hashes cover the entire field.
+ * Fields are the binary files written with --dump; they are compared cell by cell, bit for bit.
+ * Usage: verify OUTPUT REFERENCE... [--field FIELD REFERENCE_FIELD]
+ * The exit status is 0 if everything compared is identical, 1 otherwise.
+ **/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <inttypes.h>
+#include <math.h>
+
+#include "fingerprint.h"
+
+/**
+ * @brief What is known about one snapshot.
+ **/
+struct record
+{
+	/// The iteration at which the snapshot was taken.
+	int iteration;
+	/// The temperature change printed, as a string to compare it the way it was printed; empty if unknown.
+	char change[64];
+	/// Tells whether the hash is known.
+	int has_hash;
+	/// The hash of the entire field.
+	uint64_t hash;
+};
+
+/**
+ * @brief A list of snapshots sorted by iteration.
+ **/
+struct records
+{
+	/// The snapshots.
+	struct record* data;
+	/// The number of snapshots.
+	size_t count;
+	/// The number of snapshots that can be stored before growing.
+	size_t capacity;
+};
+
+static void echo_success(const char* message)
+{
+	printf("\033[32m[SUCCESS]\033[0m %s\n", message);
+}
+
+static void echo_failure(const char* message)
+{
+	printf("\033[31m[FAILURE]\033[0m %s\n", message);
+}
+
+/**
+ * @brief Returns the record of an iteration, creating it if needed.
+ **/
+static struct record* find_record(struct records* records, int iteration, int create)
+{
+	// Outputs are printed in increasing iteration order, so the common case is the last one or a new one
+	size_t low = 0;
+	size_t high = records->count;
+	while(low < high)
+	{
+		size_t middle = (low + high) / 2;
+		if(records->data[middle].iteration < iteration)
+		{
+			low = middle + 1;
+		}
+		else
+		{
+			high = middle;
+		}
+	}
+	if(low < records->count && records->data[low].iteration == iteration)
+	{
+		return &records->data[low];
+	}
+	if(!create)
+	{
+		return NULL;
+	}
+	if(records->count == records->capacity)
+	{
+		records->capacity = records->capacity ? records->capacity * 2 : 256;
+		records->data = realloc(records->data, records->capacity * sizeof(struct record));
+		if(records->data == NULL)
+		{
+			echo_failure("Out of memory.");
+			exit(EXIT_FAILURE);
+		}
+	}
+	memmove(&records->data[low + 1], &records->data[low], (records->count - low) * sizeof(struct record));
+	records->count++;
+	struct record* record = &records->data[low];
+	memset(record, 0, sizeof(*record));
+	record->iteration = iteration;
+	return record;
+}
+
+/**
+ * @brief Reads the snapshots printed in a file.
+ * @return 0 on success, -1 if the file cannot be opened.
+ **/
+static int read_records(const char* path, struct records* records, int* iterations_executed)
+{
+	FILE* file = fopen(path, "r");
+	if(file == NULL)
+	{
+		return -1;
+	}
+	char line[512];
+	while(fgets(line, sizeof(line), file) != NULL)
+	{
+		int iteration;
+		char value[64];
+		if(sscanf(line, " Iteration %d: %63s", &iteration, value) == 2)
+		{
+			strcpy(find_record(records, iteration, 1)->change, value);
+		}
+		else if(sscanf(line, " Hash %d: %63s", &iteration, value) == 2)
+		{
+			struct record* record = find_record(records, iteration, 1);
+			record->has_hash = 1;
+			record->hash = strtoull(value, NULL, 16);
+		}
+		else if(iterations_executed != NULL && strstr(line, "The program took") != NULL)
+		{
+			char* executed = strstr(line, "executed");
+			if(executed != NULL)
+			{
+				sscanf(executed, "executed %d", iterations_executed);
+			}
+		}
+	}
+	fclose(file);
+	return 0;
+}
+
+/**
+ * @brief Reads a field written with --dump.
+ * @return The values of the field, NULL on error.
+ **/
+static double* read_field(const char* path, struct fingerprint_field_header* header)
+{
+	FILE* file = fopen(path, "rb");
+	if(file == NULL)
+	{
+		return NULL;
+	}
+	double* field = NULL;
+	if(fread(header, sizeof(*header), 1, file) == 1 && header->magic == FINGERPRINT_FIELD_MAGIC && header->rows > 0 && header->columns > 0)
+	{
+		size_t count = (size_t)header->rows * (size_t)header->columns;
+		field = malloc(count * sizeof(double));
+		if(field != NULL && fread(field, sizeof(double), count, file) != count)
+		{
+			free(field);
+			field = NULL;
+		}
+	}
+	fclose(file);
+	return field;
+}
+
+/**
+ * @brief Compares two fields bit for bit.
+ * @return 0 if they are identical, -1 otherwise.
+ **/
+static int compare_fields(const char* path, const char* reference_path)
+{
+	char message[512];
+	struct fingerprint_field_header header;
+	struct fingerprint_field_header reference_header;
+	double* field = read_field(path, &header);
+	double* reference_field = read_field(reference_path, &reference_header);
+	int result = -1;
+	if(field == NULL || reference_field == NULL)
+	{
+		snprintf(message, sizeof(message), "Cannot read the field \"%s\".", field == NULL ? path : reference_path);
+		echo_failure(message);
+	}
+	else if(header.rows != reference_header.rows || header.columns != reference_header.columns)
+	{
+		snprintf(message, sizeof(message), "The fields have different dimensions: %" PRId64 "x%" PRId64 " (reference) vs %" PRId64 "x%" PRId64 " (you).",
+				 reference_header.rows, reference_header.columns, header.rows, header.columns);
+		echo_failure(message);
+	}
+	else if(header.iteration != reference_header.iteration)
+	{
+		snprintf(message, sizeof(message), "The fields were written after a different number of iterations: %" PRId64 " (reference) vs %" PRId64 " (you).",
+				 reference_header.iteration, header.iteration);
+		echo_failure(message);
+	}
+	else
+	{
+		size_t count = (size_t)header.rows * (size_t)header.columns;
+		size_t differences = 0;
+		size_t first_difference = 0;
+		double max_difference = 0.0;
+		for(size_t i = 0; i < count; i++)
+		{
+			if(memcmp(&field[i], &reference_field[i], sizeof(double)) != 0)
+			{
+				if(differences == 0)
+				{
+					first_difference = i;
+				}
+				differences++;
+				max_difference = fmax(max_difference, fabs(field[i] - reference_field[i]));
+			}
+		}
+		if(differences == 0)
+		{
+			snprintf(message, sizeof(message), "All %zu cells of the field after %" PRId64 " iterations are identical to the reference.", count, header.iteration);
+			echo_success(message);
+			result = 0;
+		}
+		else
+		{
+			snprintf(message, sizeof(message), "%zu cells differ from the reference, by up to %.18f; the first one is at row %zu column %zu: %.18f (reference) vs %.18f (you).",
+					 differences, max_difference, first_difference / header.columns, first_difference % header.columns, reference_field[first_difference], field[first_difference]);
+			echo_failure(message);
+		}
+	}
+	free(field);
+	free(reference_field);
+	return result;
+}
+
+int main(int argc, char* argv[])
+{
+	const char* field_path = NULL;
+	const char* reference_field_path = NULL;
+	const char* paths[argc];
+	int path_count = 0;
+	for(int i = 1; i < argc; i++)
+	{
+		if(strcmp(argv[i], "--field") == 0 && i + 2 < argc)
+		{
+			field_path = argv[++i];
+			reference_field_path = argv[++i];
+		}
+		else
+		{
+			paths[path_count++] = argv[i];
+		}
+	}
+	if(path_count < 2)
+	{
+		printf("Usage: %s OUTPUT REFERENCE... [--field FIELD REFERENCE_FIELD]\n", argv[0]);
+		return EXIT_FAILURE;
+	}
+
+	char message[512];
+	struct records output = {NULL, 0, 0};
+	struct records reference = {NULL, 0, 0};
+	int iterations_executed = -1;
+	int reference_iterations_executed = -1;
+	if(read_records(paths[0], &output, &iterations_executed) != 0)
+	{
+		snprintf(message, sizeof(message), "Cannot read the output \"%s\".", paths[0]);
+		echo_failure(message);
+		return EXIT_FAILURE;
+	}
+	for(int i = 1; i < path_count; i++)
+	{
+		if(read_records(paths[i], &reference, &reference_iterations_executed) != 0)
+		{
+			snprintf(message, sizeof(message), "Cannot read the reference \"%s\".", paths[i]);
+			echo_failure(message);
+			return EXIT_FAILURE;
+		}
+	}
+	if(output.count == 0)
+	{
+		snprintf(message, sizeof(message), "No iteration found in \"%s\".", paths[0]);
+		echo_failure(message);
+		return EXIT_FAILURE;
+	}
+
+	int result = EXIT_SUCCESS;
+	size_t changes_compared = 0;
+	size_t hashes_compared = 0;
+	for(size_t i = 0; i < output.count && result == EXIT_SUCCESS; i++)
+	{
+		const struct record* mine = &output.data[i];
+		const struct record* theirs = find_record(&reference, mine->iteration, 0);
+		if(theirs == NULL)
+		{
+			continue;
+		}
+		if(mine->change[0] != '\0' && theirs->change[0] != '\0')
+		{
+			if(strcmp(mine->change, theirs->change) != 0)
+			{
+				snprintf(message, sizeof(message), "Iteration %d differs: %s (reference) vs %s (you).", mine->iteration, theirs->change, mine->change);
+				echo_failure(message);
+				result = EXIT_FAILURE;
+			}
+			changes_compared++;
+		}
+		if(mine->has_hash && theirs->has_hash)
+		{
+			if(mine->hash != theirs->hash)
+			{
+				snprintf(message, sizeof(message), "The field at iteration %d differs: hash 0x%016" PRIx64 " (reference) vs 0x%016" PRIx64 " (you).", mine->iteration, theirs->hash, mine->hash);
+				echo_failure(message);
+				result = EXIT_FAILURE;
+			}
+			hashes_compared++;
+		}
+	}
+
+	if(result == EXIT_SUCCESS)
+	{
+		if(changes_compared + hashes_compared == 0)
+		{
+			echo_failure("No iteration in common with the reference.");
+			result = EXIT_FAILURE;
+		}
+		else
+		{
+			snprintf(message, sizeof(message), "%zu temperature changes and %zu field hashes compared are identical to the reference.", changes_compared, hashes_compared);
+			echo_success(message);
+			if(iterations_executed >= 0 && reference_iterations_executed >= 0)
+			{
+				snprintf(message, sizeof(message), "Number of iterations achieved: %d (reference) vs %d (you).", reference_iterations_executed, iterations_executed);
+				echo_success(message);
+			}
+		}
+	}
+
+	if(field_path != NULL && compare_fields(field_path, reference_field_path) != 0)
+	{
+		result = EXIT_FAILURE;
+	}
+
+	free(output.data);
+	free(reference.data);
+	return result;
+}
@@ -0,0 +1,91 @@
+/**
+ * @file warm_start.c
+ * @brief Coarse-to-fine warm start of steady-state runs.
+ **/
+
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <mpi.h>
+
+#include "sor.h"
+#include "resample.h"
+#include "warm_start.h"
+
+int warm_start(struct slab* slab, const double* plate, double* scratch, int factor, double tolerance, int root)
+{
+	const int rows = slab->total_rows;
+	const int columns = slab->columns;
+	const int coarse_rows = (rows + factor - 1) / factor;
+	const int coarse_columns = (columns + factor - 1) / factor;
+
+	struct slab coarse;
+	int created = slab_create(&coarse, slab->comm, coarse_rows, coarse_columns) == 0;
+	int everybody_created;
+	MPI_Allreduce(&created, &everybody_created, 1, MPI_INT, MPI_MIN, slab->comm);
+	if(!everybody_created)
+	{
+		slab_destroy(&coarse);
+		return -1;
+	}
+
+	// The coarse plate is built in the scratch buffer; the plate is cold outside its sources, so the coarse plate is too
+	if(slab->my_rank == root)
+	{
+		resample_coarsen(plate, rows, columns, factor, scratch);
+	}
+	slab_scatter(&coarse, scratch, root);
+
+	const double omega = sor_optimal_omega(coarse_rows);
+	int iterations = 0;
+	double global_temperature_change;
+	do
+	{
+		slab_exchange_ghost_rows(&coarse, coarse.temperatures_last);
+		double my_temperature_change = sor_sweep(coarse.temperatures_last, coarse.fixed, coarse.rows, coarse_columns, coarse.first_global_row, SOR_RED, omega);
+		slab_exchange_ghost_rows(&coarse, coarse.temperatures_last);
+		my_temperature_change = fmax(sor_sweep(coarse.temperatures_last, coarse.fixed, coarse.rows, coarse_columns, coarse.first_global_row, SOR_BLACK, omega), my_temperature_change);
+		MPI_Allreduce(&my_temperature_change, &global_temperature_change, 1, MPI_DOUBLE, MPI_MAX, slab->comm);
+		iterations++;
+	} while(global_temperature_change >= tolerance);
+
+	// The root interpolates the coarse steady state, then everybody takes their rows
+	double* coarse_plate = NULL;
+	if(slab->my_rank == root)
+	{
+		coarse_plate = malloc((size_t)coarse_rows * coarse_columns * sizeof(double));
+		if(coarse_plate == NULL)
+		{
+			MPI_Abort(slab->comm, EXIT_FAILURE);
+		}
+	}
+	MPI_Gatherv(&coarse.temperatures_last[coarse_columns], coarse.rows * coarse_columns, MPI_DOUBLE, coarse_plate, coarse.cell_counts, coarse.cell_offsets, MPI_DOUBLE, root, slab->comm);
+	slab_destroy(&coarse);
+	if(slab->my_rank == root)
+	{
+		resample_interpolate(coarse_plate, rows, columns, factor, scratch);
+		free(coarse_plate);
+	}
+	MPI_Scatterv(scratch, slab->cell_counts, slab->cell_offsets, MPI_DOUBLE, &slab->temperatures[columns], slab->rows * columns, MPI_DOUBLE, root, slab->comm);
+
+	// Sources keep the temperature of the plate. The Jacobi propagation tells sources by their value, so an interpolated cell must stay strictly below MAX_TEMPERATURE: between sources, a cell that is not one may well be interpolated from coarse cells that all are.
+	const double hottest = nextafter(MAX_TEMPERATURE, 0.0);
+	#pragma omp parallel for
+	for(int i = 0; i < slab->rows; i++)
+	{
+		for(int j = 0; j < columns; j++)
+		{
+			const size_t cell = (size_t)(i + 1) * columns + j;
+			if(slab->fixed[(size_t)i * columns + j])
+			{
+				slab->temperatures[cell] = slab->temperatures_last[cell];
+			}
+			else
+			{
+				slab->temperatures[cell] = fmin(slab->temperatures[cell], hottest);
+				slab->temperatures_last[cell] = slab->temperatures[cell];
+			}
+		}
+	}
+	return iterations;
+}
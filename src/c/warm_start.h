@@ -0,0 +1,26 @@
+/**
+ * @file warm_start.h
+ * @brief Coarse-to-fine warm start of steady-state runs.
+ * @details From a cold plate, the first iterations of any local method only push the heat one cell further every iteration. The warm start first solves a plate coarsened by 2 or 4 in both directions, on which the heat has a quarter or a sixteenth of the distance to cover, then interpolates its steady state onto the plate as the initial temperatures of the solver.
+ * A coarse cell is a source if any of the cells it covers is, so that sources one cell wide survive the coarsening. The coarse plate is solved with red-black SOR, decomposed across the same MPI processes as the plate.
+ **/
+
+#ifndef WARM_START_H_INCLUDED
+#define WARM_START_H_INCLUDED
+
+#include "slab.h"
+
+/**
+ * @brief Replaces the temperatures of the cells that are not sources by the interpolated steady state of a coarsened plate.
+ * @details This is a collective operation, to make once the plate has been scattered, so that the sources are those of the plate and not of the interpolation.
+ * @param[in,out] slab The slab, whose two buffers are overwritten.
+ * @param[in] plate The entire plate, significant on the root MPI process only.
+ * @param[out] scratch A buffer of the size of the plate, significant on the root MPI process only.
+ * @param[in] factor The coarsening factor in both directions.
+ * @param[in] tolerance The coarse plate is solved until its maximum temperature change falls below it.
+ * @param[in] root The rank of the MPI process holding the plate.
+ * @return The number of iterations of the coarse solve, -1 if the coarse plate cannot be decomposed across the MPI processes or allocated, in which case the slab is left untouched.
+ **/
+int warm_start(struct slab* slab, const double* plate, double* scratch, int factor, double tolerance, int root);
+
+#endif